@@ -0,0 +1,81 @@
+#include "autoplay.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include "moves.h"
+#include "pile.h"
+#include "rule_tables.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file autoplay.c
+ * Implements safe automatic foundation play.
+ * Cards are moved with pick_up_cards and place_card_on_foundation, like a player's moves,
+ * and each move is recorded as an undo entry so searches can take it back with undo_move.
+ */
+
+/**
+ * Checks if a card can go to its foundation without ever being missed.
+ * The only cards that can be placed on a card are the opposite-colour cards one rank lower,
+ * so once both of those are on their foundations nothing can need the card any more.
+ * Only Aces are always safe. Unlike Klondike, a Two is not: an opposite-colour Ace can carry
+ * the cards above it onto the Two, which may be the only way to uncover what lies below the Ace.
+ */
+bool is_safe_to_autoplay(const Board *board, Card card)
+{
+    if (card.rank == 1)
+        return true;
+    bool color = get_card_color(card);
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        const Foundation *foundation = &board->foundations[f];
+        // Foundations hold Ace up to their top card, so top + 1 is the highest rank on them
+        if (get_card_color((Card){.rank = 1, .suit = foundation->suit}) != color && foundation->top + 1 < card.rank - 1)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Sends every safe card that is on top of a tableau to its foundation,
+ * repeating until no more can go (a card sent up can uncover or make safe the next one).
+ * If undo_entries is not NULL, it receives one entry per card moved (at most MAX_AUTOPLAY_MOVES),
+ * in the order the cards were moved, marked as automatic.
+ * Returns the number of cards moved.
+ */
+int autoplay_safe_cards(Board *board, UndoEntry *undo_entries)
+{
+    int num_moved = 0;
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (int f = 0; f < NUM_SUITS; f++)
+        {
+            Foundation *foundation = &board->foundations[f];
+            if (foundation->top + 1 >= FOUNDATION_SIZE)
+                continue;
+            // The only card this foundation accepts; the location index says whether it is free to move
+            Card next = {.rank = (uint8_t)(foundation->top + 2), .suit = (uint8_t)foundation->suit};
+            if (!is_card_on_top(board, next))
+                continue;
+            Card top_card = (foundation->top >= 0) ? foundation->cards[foundation->top] : (Card){0};
+            if (!fits_on_foundation(next, top_card, foundation->suit) || !is_safe_to_autoplay(board, next))
+                continue;
+
+            CardLocation location = find_card(board, next);
+            Tableau *tableau = &board->tableaus[location.pile];
+            bool flips = location.position > 0 && tableau->cards[location.position - 1].is_face_down;
+            if (pick_up_cards(board, location.pile, 1) != MOVE_OK)
+                continue;
+            if (place_card_on_foundation(board, f) != MOVE_OK)
+                continue;
+            if (undo_entries != NULL)
+                undo_entries[num_moved] = (UndoEntry){{MOVE_TO_FOUNDATION, location.pile, (uint8_t)f, 1}, flips, true};
+            num_moved++;
+            progress = true;
+        }
+    }
+    return num_moved;
+}
@@ -0,0 +1,23 @@
+#ifndef AUTOPLAY_H
+#define AUTOPLAY_H
+
+#include "board.h"
+#include "cards.h"
+#include "moves.h"
+#include <stdbool.h>
+
+/**
+ * @file autoplay.h
+ * Defines safe automatic foundation play: sending cards to the foundations
+ * when no card left in the tableaus could ever need them.
+ */
+
+/**
+ * Maximum number of cards one call to autoplay_safe_cards can move.
+ */
+#define MAX_AUTOPLAY_MOVES DECK_SIZE
+
+bool is_safe_to_autoplay(const Board *board, Card card);
+int autoplay_safe_cards(Board *board, UndoEntry *undo_entries);
+
+#endif // AUTOPLAY_H
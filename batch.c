@@ -0,0 +1,319 @@
+/**
+ * @file batch.c
+ * Entry point for yukon-batch, which solves every deal in a range of seeds on all cores.
+ *
+ * Usage: yukon-batch <first_seed> <count> <output_file> [--threads N] [--mode full|honest|playout] [--nodes N] [--playouts N]
+ *
+ * Each seed is dealt with initialize_board_from_seed and solved with solve_board,
+ * or in playout mode simulated with heuristic playouts.
+ * The results file has one line per seed: seed,result,nodes,time_us
+ * (in playout mode result is the win rate and nodes the number of moves played).
+ *
+ * Solve times vary by orders of magnitude between deals, so the seeds are split
+ * evenly between worker threads up front and idle workers steal half of the
+ * remaining seeds from a busy worker.
+ */
+
+#include "board.h"
+#include "playout.h"
+#include "rng.h"
+#include "solver.h"
+#include "transposition.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BATCH_TABLE_LOG2_ENTRIES 20 // Transposition table per worker (2^20 slots, 8 MB)
+#define BATCH_DEFAULT_NODES 1000000 // Default node limit per deal
+#define BATCH_DEFAULT_PLAYOUTS 100  // Default number of playouts per deal in playout mode
+
+/**
+ * Represents the result of one deal.
+ */
+typedef struct
+{
+    uint8_t status;  // SolveStatus of the deal
+    double win_rate; // Fraction of playouts won (playout mode)
+    uint64_t nodes;  // Number of positions searched (moves played in playout mode)
+    uint64_t time_us;
+} BatchResult;
+
+/**
+ * Represents one worker thread and the seeds it still has to solve.
+ * The range of seed offsets is packed into one atomic word
+ * (next offset in the low 32 bits, end offset in the high 32 bits),
+ * so the owner and thieves can both update it with compare-and-swap.
+ */
+typedef struct
+{
+    _Alignas(64) _Atomic uint64_t range; // Own cache line, so workers do not slow each other down
+    pthread_t thread;
+    int index;
+    TranspositionTable table;
+    SolveResult solution;
+} Worker;
+
+/**
+ * Holds the settings and shared state of a batch run.
+ */
+typedef struct
+{
+    uint64_t first_seed;
+    uint32_t count;
+    SolveMode mode;
+    bool simulate; // Whether to run playouts instead of solving
+    int playouts;  // Number of playouts per deal
+    uint64_t max_nodes;
+    int num_workers;
+    Worker *workers;
+    BatchResult *results; // One result per seed, written by whichever worker solved it
+} Batch;
+
+static Batch batch;
+
+/**
+ * Helper function to pack a range of seed offsets into one word.
+ */
+static inline uint64_t pack_range(uint32_t next, uint32_t end)
+{
+    return ((uint64_t)end << 32) | next;
+}
+
+/**
+ * Takes the next seed offset from the worker's own range.
+ * Returns false if the range is empty.
+ */
+static bool take_own(Worker *worker, uint32_t *offset)
+{
+    uint64_t range = atomic_load(&worker->range);
+    while (true)
+    {
+        uint32_t next = (uint32_t)range, end = (uint32_t)(range >> 32);
+        if (next >= end)
+            return false;
+        if (atomic_compare_exchange_weak(&worker->range, &range, pack_range(next + 1, end)))
+        {
+            *offset = next;
+            return true;
+        }
+    }
+}
+
+/**
+ * Steals the upper half of another worker's remaining range into the thief's own range.
+ * Returns false if no worker has seeds left.
+ */
+static bool steal(Worker *thief)
+{
+    for (int i = 1; i < batch.num_workers; i++)
+    {
+        Worker *victim = &batch.workers[(thief->index + i) % batch.num_workers];
+        uint64_t range = atomic_load(&victim->range);
+        while (true)
+        {
+            uint32_t next = (uint32_t)range, end = (uint32_t)(range >> 32);
+            if (next >= end)
+                break;
+            uint32_t middle = next + (end - next) / 2;
+            if (atomic_compare_exchange_weak(&victim->range, &range, pack_range(next, middle)))
+            {
+                atomic_store(&thief->range, pack_range(middle, end));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Helper function to read a monotonic clock in microseconds.
+ */
+static uint64_t now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+/**
+ * Thread function: solves seeds from the worker's range until no worker has any left.
+ */
+static void *run_worker(void *arg)
+{
+    Worker *worker = arg;
+    uint32_t offset;
+    while (take_own(worker, &offset) || (steal(worker) && take_own(worker, &offset)))
+    {
+        Board board;
+        initialize_board_from_seed(&board, batch.first_seed + offset);
+        BatchResult *result = &batch.results[offset];
+        if (batch.simulate)
+        {
+            // Seed the playouts from the deal, so results do not depend on the thread
+            Rng rng;
+            rng_seed(&rng, batch.first_seed + offset);
+            PlayoutStats stats = {0};
+            uint64_t start = now_us();
+            run_playouts(&board, POLICY_HEURISTIC, batch.playouts, &rng, &stats);
+            result->time_us = now_us() - start;
+            result->win_rate = get_win_rate(&stats);
+            result->nodes = stats.total_moves;
+        }
+        else
+        {
+            uint64_t start = now_us();
+            solve_board(&board, batch.mode, batch.max_nodes, &worker->table, &worker->solution);
+            result->time_us = now_us() - start;
+            result->status = (uint8_t)worker->solution.status;
+            result->nodes = worker->solution.nodes;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Helper function to print usage information.
+ */
+static void print_usage()
+{
+    fprintf(stderr, "Usage: yukon-batch <first_seed> <count> <output_file> [--threads N] [--mode full|honest|playout] [--nodes N] [--playouts N]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+    batch.first_seed = strtoull(argv[1], NULL, 10);
+    unsigned long long count = strtoull(argv[2], NULL, 10);
+    const char *output_path = argv[3];
+    if (count == 0 || count > UINT32_MAX)
+    {
+        fprintf(stderr, "Error: count must be between 1 and %u.\n", UINT32_MAX);
+        return EXIT_FAILURE;
+    }
+    batch.count = (uint32_t)count;
+    batch.mode = SOLVE_FULL_INFORMATION;
+    batch.max_nodes = BATCH_DEFAULT_NODES;
+    batch.playouts = BATCH_DEFAULT_PLAYOUTS;
+    batch.num_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 4; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            batch.num_workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--nodes") == 0 && i + 1 < argc)
+            batch.max_nodes = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--playouts") == 0 && i + 1 < argc)
+            batch.playouts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "full") == 0)
+                batch.mode = SOLVE_FULL_INFORMATION;
+            else if (strcmp(argv[i], "honest") == 0)
+                batch.mode = SOLVE_HONEST;
+            else if (strcmp(argv[i], "playout") == 0)
+                batch.simulate = true;
+            else
+            {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (batch.num_workers < 1)
+        batch.num_workers = 1;
+
+    // Open the output first, so a bad path fails before any deal is solved
+    FILE *output = fopen(output_path, "w");
+    if (output == NULL)
+    {
+        fprintf(stderr, "Error: Unable to open %s for writing.\n", output_path);
+        return EXIT_FAILURE;
+    }
+    batch.results = calloc(batch.count, sizeof(BatchResult));
+    batch.workers = aligned_alloc(64, sizeof(Worker) * (size_t)batch.num_workers);
+    if (batch.results == NULL || batch.workers == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate memory for batch.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Split the seeds evenly between the workers to start with
+    uint64_t start = now_us();
+    for (int i = 0; i < batch.num_workers; i++)
+    {
+        Worker *worker = &batch.workers[i];
+        worker->index = i;
+        uint32_t begin = (uint32_t)((uint64_t)batch.count * i / batch.num_workers);
+        uint32_t end = (uint32_t)((uint64_t)batch.count * (i + 1) / batch.num_workers);
+        atomic_init(&worker->range, pack_range(begin, end));
+        if (!create_transposition_table(&worker->table, BATCH_TABLE_LOG2_ENTRIES))
+        {
+            fprintf(stderr, "Error: Unable to allocate memory for transposition table.\n");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < batch.num_workers; i++)
+    {
+        if (pthread_create(&batch.workers[i].thread, NULL, run_worker, &batch.workers[i]) != 0)
+        {
+            fprintf(stderr, "Error: Unable to start worker thread %d.\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < batch.num_workers; i++)
+    {
+        pthread_join(batch.workers[i].thread, NULL);
+        free_transposition_table(&batch.workers[i].table);
+    }
+    uint64_t elapsed_us = now_us() - start;
+
+    // Write the results in seed order
+    const char *status_names[] = {"won", "lost", "unknown"};
+    uint32_t totals[3] = {0};
+    double total_win_rate = 0;
+    fprintf(output, "seed,result,nodes,time_us\n");
+    for (uint32_t i = 0; i < batch.count; i++)
+    {
+        BatchResult *result = &batch.results[i];
+        unsigned long long seed = (unsigned long long)(batch.first_seed + i);
+        if (batch.simulate)
+        {
+            total_win_rate += result->win_rate;
+            fprintf(output, "%llu,%.4f,%llu,%llu\n", seed, result->win_rate,
+                    (unsigned long long)result->nodes, (unsigned long long)result->time_us);
+        }
+        else
+        {
+            totals[result->status]++;
+            fprintf(output, "%llu,%s,%llu,%llu\n", seed, status_names[result->status],
+                    (unsigned long long)result->nodes, (unsigned long long)result->time_us);
+        }
+    }
+    fclose(output);
+
+    fprintf(stderr, "%u deals on %d threads in %.3f s (%.1f deals/s): ",
+            batch.count, batch.num_workers, elapsed_us / 1e6, batch.count / (elapsed_us / 1e6));
+    if (batch.simulate)
+        fprintf(stderr, "mean win rate %.4f\n", total_win_rate / batch.count);
+    else
+        fprintf(stderr, "%u won, %u lost, %u unknown\n", totals[SOLVE_WON], totals[SOLVE_LOST], totals[SOLVE_UNKNOWN]);
+    free(batch.results);
+    free(batch.workers);
+    return 0;
+}
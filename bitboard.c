@@ -0,0 +1,50 @@
+#include "bitboard.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+
+/**
+ * @file bitboard.c
+ * Implements building the bitboard view of a board.
+ */
+
+/**
+ * Fills in the bitboard for the board.
+ * Cards in the hand are not included.
+ */
+void build_bitboard(const Board *board, Bitboard *bitboard)
+{
+    bitboard->face_up = 0;
+    bitboard->tops = 0;
+    bitboard->empty_tableaus = 0;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        const Tableau *tableau = &board->tableaus[t];
+        bitboard->tableau_tops[t] = 0;
+        bitboard->tableau_face_up[t] = 0;
+        if (tableau->top < 0)
+        {
+            bitboard->empty_tableaus |= (uint8_t)(1 << t);
+            continue;
+        }
+        // Face-up cards are always above the face-down ones, so walk down from the top
+        for (int i = tableau->top; i >= 0 && !tableau->cards[i].is_face_down; i--)
+        {
+            bitboard->tableau_face_up[t] |= get_card_mask(tableau->cards[i]);
+        }
+        bitboard->face_up |= bitboard->tableau_face_up[t];
+        if (!tableau->cards[tableau->top].is_face_down)
+            bitboard->tableau_tops[t] = get_card_mask(tableau->cards[tableau->top]);
+        bitboard->tops |= bitboard->tableau_tops[t];
+    }
+
+    bitboard->foundation_next = 0;
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        const Foundation *foundation = &board->foundations[f];
+        bitboard->foundation_by_suit[foundation->suit] = (int8_t)f;
+        // A full foundation accepts nothing
+        if (foundation->top + 1 < FOUNDATION_SIZE)
+            bitboard->foundation_next |= 1ULL << (foundation->suit * FOUNDATION_SIZE + foundation->top + 1);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include <stdint.h>
+
+/**
+ * @file bitboard.h
+ * Defines a bitboard view of the board: sets of cards as 52-bit masks,
+ * one bit per card at get_card_index (suit by suit, Ace to King).
+ * Rule questions about many cards at once, such as which cards fit on any tableau top,
+ * are answered with a few shifts and masks instead of one rule call per card pair.
+ */
+
+/**
+ * A set of cards, bit get_card_index(card) for each card in the set.
+ */
+typedef uint64_t CardMask;
+
+#define SUIT_MASK 0x1FFFULL                                                                       // The 13 cards of the first suit
+#define RED_MASK ((SUIT_MASK << (HEARTS * FOUNDATION_SIZE)) | (SUIT_MASK << (DIAMONDS * FOUNDATION_SIZE))) // Hearts and Diamonds
+#define BLACK_MASK ((SUIT_MASK << (CLUBS * FOUNDATION_SIZE)) | (SUIT_MASK << (SPADES * FOUNDATION_SIZE)))  // Clubs and Spades
+#define ACES_MASK 0x8004002001ULL                                                                 // The Ace of every suit
+#define KINGS_MASK (ACES_MASK << 12)                                                              // The King of every suit
+
+/**
+ * Represents the cards of a board as masks.
+ */
+typedef struct
+{
+    CardMask face_up;                       // Every face-up card in the tableaus
+    CardMask tableau_face_up[NUM_TABLEAUS]; // Face-up cards of each tableau
+    CardMask tableau_tops[NUM_TABLEAUS];    // Top card of each tableau, or 0 if it is empty or face-down
+    CardMask tops;                          // Union of tableau_tops
+    CardMask foundation_next;               // The card each foundation accepts next
+    uint8_t empty_tableaus;                 // Bit t is set if tableau t is empty
+    int8_t foundation_by_suit[NUM_SUITS];   // Index of the foundation for each suit
+} Bitboard;
+
+/**
+ * Returns the mask of a single card.
+ */
+static inline CardMask get_card_mask(Card card)
+{
+    return 1ULL << get_card_index(card);
+}
+
+/**
+ * Returns every card that can be placed on at least one of the given (face-up) top cards:
+ * one rank lower and of the opposite colour.
+ * Empty tableaus are not included; they accept KINGS_MASK.
+ */
+static inline CardMask get_tableau_acceptors(CardMask tops)
+{
+    // One rank lower in the same suit; an Ace accepts nothing, so drop what shifts into the King below it
+    CardMask lower = (tops >> 1) & ~KINGS_MASK;
+    // Fold each colour onto one suit's worth of ranks, then spread the ranks over the other colour's suits
+    CardMask red_ranks = (lower | (lower >> (DIAMONDS * FOUNDATION_SIZE))) & SUIT_MASK;
+    CardMask black_ranks = ((lower >> (CLUBS * FOUNDATION_SIZE)) | (lower >> (SPADES * FOUNDATION_SIZE))) & SUIT_MASK;
+    return (red_ranks << (CLUBS * FOUNDATION_SIZE)) | (red_ranks << (SPADES * FOUNDATION_SIZE)) |
+           black_ranks | (black_ranks << (DIAMONDS * FOUNDATION_SIZE));
+}
+
+void build_bitboard(const Board *board, Bitboard *bitboard);
+
+#endif // BITBOARD_H
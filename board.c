@@ -3,6 +3,8 @@
 #include "rules.h"
 #include "constants.h"
 #include "pile.h"
+#include "rng.h"
+#include "zobrist.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +28,15 @@ Board *create_board()
         fprintf(stderr, "Error: Unable to allocate memory for game board.\n");
         exit(EXIT_FAILURE);
     }
+    reset_board(board);
+    return board;
+}
+
+/**
+ * Empties a board so it can be (re)used for a new game.
+ */
+void reset_board(Board *board)
+{
     // Initialize foundations
     for (int i = 0; i < NUM_SUITS; i++)
     {
@@ -41,8 +52,38 @@ Board *create_board()
     board->hand.size = 0;
     board->hand.origin_tableau = -1;
     board->hand.origin_position = -1;
+    board->hand.origin_flipped = false;
     memset(board->hand.cards, 0, sizeof(board->hand.cards));
-    return board;
+    // An empty board has an empty hash and no cards
+    board->hash = 0;
+    memset(board->locations, LOCATION_NONE, sizeof(board->locations));
+}
+
+/**
+ * Recomputes where every card is from the piles.
+ * Only needed after changing the piles directly; moves keep the locations up to date.
+ */
+void rebuild_card_locations(Board *board)
+{
+    memset(board->locations, LOCATION_NONE, sizeof(board->locations));
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        for (int j = 0; j <= board->tableaus[i].top; j++)
+        {
+            set_card_location(board, board->tableaus[i].cards[j], i, j);
+        }
+    }
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        for (int j = 0; j <= board->foundations[i].top; j++)
+        {
+            set_card_location(board, board->foundations[i].cards[j], LOCATION_FOUNDATION_BASE + i, j);
+        }
+    }
+    for (int j = 0; j < board->hand.size; j++)
+    {
+        set_card_location(board, board->hand.cards[j], LOCATION_HAND, j);
+    }
 }
 
 /**
@@ -54,14 +95,29 @@ void free_board(Board *board)
 }
 
 /**
- * Generates a deck of cards and populates the game board with the appropriate cards.
+ * Generates a deck of cards and populates the game board with a random deal.
  */
 void initialize_board(Board *board)
 {
-    // Initialize deck of cards
-    Card *deck = create_deck();
-    // Shuffle the deck before dealing cards to the tableaus
-    shuffle_deck(deck);
+    initialize_board_from_seed(board, random_seed());
+}
+
+/**
+ * Generates a deck of cards and populates the game board with the deal
+ * for the given seed. The same seed gives the same deal on every machine.
+ * Any cards already on the board are cleared first.
+ */
+void initialize_board_from_seed(Board *board, uint64_t seed)
+{
+    // Start from an empty board, so boards can be reused for new deals
+    reset_board(board);
+    // Initialize deck of cards on the stack (no allocation needed)
+    Card deck[DECK_SIZE];
+    fill_deck(deck);
+    // Shuffle the deck with a generator owned by this deal before dealing cards to the tableaus
+    Rng rng;
+    rng_seed(&rng, seed);
+    shuffle_deck_with_rng(deck, &rng);
     // Populate the tableaus with cards from the deck according to the rules
     int deck_index = 0;
     for (int i = 0; i < NUM_TABLEAUS; i++)
@@ -72,6 +128,7 @@ void initialize_board(Board *board)
             Card card = deck[deck_index++];
             card.is_face_down = true;
             board->tableaus[i].cards[++board->tableaus[i].top] = card;
+            set_card_location(board, card, i, board->tableaus[i].top);
         }
         // Add 5 face-up cards (or 1 for the first tableau)
         int num_face_up = (i == 0) ? 1 : 5;
@@ -80,8 +137,9 @@ void initialize_board(Board *board)
             Card card = deck[deck_index++];
             card.is_face_down = false;
             board->tableaus[i].cards[++board->tableaus[i].top] = card;
+            set_card_location(board, card, i, board->tableaus[i].top);
         }
     }
-    // Free the deck after initializing the board (no longer needed)
-    free_deck(deck);
+    // Hash the dealt position once; moves keep it up to date from here on
+    board->hash = compute_board_hash(board);
 }
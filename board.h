@@ -1,6 +1,7 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "rules.h"
 #include "cards.h"
@@ -19,8 +20,26 @@ typedef struct
     uint8_t size;               // Represents the number of cards currently in hand
     int8_t origin_tableau;      // Represents the index of the tableau where the hand came from
     int8_t origin_position;     // Represents the starting position in the tableau
+    bool origin_flipped;        // Whether picking up the cards turned the card below them face-up
 } Hand;
 
+/**
+ * Pile numbers used by CardLocation: tableaus are 0 to NUM_TABLEAUS - 1,
+ * followed by the foundations and then the hand.
+ */
+#define LOCATION_FOUNDATION_BASE NUM_TABLEAUS             // Foundation f is pile LOCATION_FOUNDATION_BASE + f
+#define LOCATION_HAND (LOCATION_FOUNDATION_BASE + NUM_SUITS) // Cards being moved
+#define LOCATION_NONE 0xFF                                // Card not on the board
+
+/**
+ * Represents where a card is: its pile and its index in that pile.
+ */
+typedef struct
+{
+    uint8_t pile;
+    uint8_t position;
+} CardLocation;
+
 /**
  * Represents the game board,
  * which consists of foundations, tableaus, and the player's hand.
@@ -29,10 +48,40 @@ typedef struct
 {
     Foundation foundations[NUM_SUITS];
     Tableau tableaus[NUM_TABLEAUS];
-    Hand hand; // Hand holds the cards that are currently being moved.
+    Hand hand;     // Hand holds the cards that are currently being moved.
+    uint64_t hash; // Zobrist hash of the position, kept up to date by every move (see zobrist.h)
+    CardLocation locations[DECK_SIZE]; // Where each card is, by get_card_index, kept up to date by every move
 } Board;
 
+/**
+ * Records where a card now is.
+ */
+static inline void set_card_location(Board *board, Card card, int pile, int position)
+{
+    board->locations[get_card_index(card)] = (CardLocation){(uint8_t)pile, (uint8_t)position};
+}
+
+/**
+ * Returns where a card is, without searching the piles.
+ */
+static inline CardLocation find_card(const Board *board, Card card)
+{
+    return board->locations[get_card_index(card)];
+}
+
+/**
+ * Checks if a card is the top card of a tableau (and so could be moved on its own).
+ */
+static inline bool is_card_on_top(const Board *board, Card card)
+{
+    CardLocation location = find_card(board, card);
+    return location.pile < NUM_TABLEAUS && location.position == board->tableaus[location.pile].top;
+}
+
 Board *create_board();
+void reset_board(Board *board);
 void initialize_board(Board *board);
+void initialize_board_from_seed(Board *board, uint64_t seed);
+void rebuild_card_locations(Board *board);
 void free_board(Board *board);
 #endif // BOARD_H
\ No newline at end of file
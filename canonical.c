@@ -0,0 +1,153 @@
+#include "canonical.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include "packed.h"
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file canonical.c
+ * Implements the canonical form of a position.
+ * The column order is fixed by sorting the tableaus, and the suit renaming by trying
+ * all of them and keeping the smallest result, so the form needs no search.
+ */
+
+/**
+ * The suit renamings that keep colours apart, as the new suit of each suit.
+ */
+static const uint8_t suit_permutations[NUM_SUIT_PERMUTATIONS][NUM_SUITS] = {
+    {HEARTS, DIAMONDS, CLUBS, SPADES},
+    {DIAMONDS, HEARTS, CLUBS, SPADES},
+    {HEARTS, DIAMONDS, SPADES, CLUBS},
+    {DIAMONDS, HEARTS, SPADES, CLUBS},
+    {CLUBS, SPADES, HEARTS, DIAMONDS},
+    {SPADES, CLUBS, HEARTS, DIAMONDS},
+    {CLUBS, SPADES, DIAMONDS, HEARTS},
+    {SPADES, CLUBS, DIAMONDS, HEARTS},
+};
+
+/**
+ * Helper function to rename the suit of a card.
+ */
+static inline Card rename_card(Card card, const uint8_t *permutation)
+{
+    card.suit = permutation[card.suit];
+    return card;
+}
+
+/**
+ * Helper function to get the byte a card is stored as, for ordering.
+ */
+static inline uint8_t get_card_byte(Card card)
+{
+    uint8_t byte;
+    memcpy(&byte, &card, sizeof(byte));
+    return byte;
+}
+
+/**
+ * Helper function to pack a board after renaming its suits, with the tableaus sorted.
+ * Every card is unique, so two non-empty tableaus always differ in their bottom card
+ * and sorting by the (renamed) bottom card orders them completely. Empty tableaus go last.
+ */
+static void pack_renamed_board(const Board *board, const uint8_t *permutation, PackedBoard *packed)
+{
+    int keys[NUM_TABLEAUS];
+    int order[NUM_TABLEAUS];
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        const Tableau *tableau = &board->tableaus[t];
+        keys[t] = (tableau->top < 0) ? 0x100 : get_card_byte(rename_card(tableau->cards[0], permutation));
+        // Insertion sort of the tableaus (there are only 7)
+        int j = t;
+        while (j > 0 && keys[order[j - 1]] > keys[t])
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = t;
+    }
+
+    int index = 0;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        const Tableau *tableau = &board->tableaus[order[t]];
+        for (int i = 0; i <= tableau->top; i++)
+        {
+            packed->cards[index++] = rename_card(tableau->cards[i], permutation);
+        }
+        packed->tableau_sizes[t] = (uint8_t)(tableau->top + 1);
+    }
+    // Cards on the foundations leave their slots unused; keep them zero so equal forms compare equal
+    memset(&packed->cards[index], 0, (size_t)(DECK_SIZE - index) * sizeof(Card));
+    // Foundation f holds suit f, so a renamed suit moves its foundation along with it
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        packed->foundation_sizes[permutation[board->foundations[f].suit]] = (uint8_t)(board->foundations[f].top + 1);
+    }
+    packed->reserved = 0;
+}
+
+/**
+ * Writes the canonical form of the board.
+ * Returns false if the board has cards in hand (like pack_board).
+ */
+bool canonicalize_board(const Board *board, PackedBoard *canonical)
+{
+    if (board->hand.size != 0)
+        return false;
+    // The packed form starts with the smallest renamed bottom card, so only the renamings
+    // that make it as small as possible can win; most of the time that is just one or two
+    int first_keys[NUM_SUIT_PERMUTATIONS];
+    int best_first_key = 0x100;
+    for (int p = 0; p < NUM_SUIT_PERMUTATIONS; p++)
+    {
+        first_keys[p] = 0x100;
+        for (int t = 0; t < NUM_TABLEAUS; t++)
+        {
+            if (board->tableaus[t].top < 0)
+                continue;
+            int key = get_card_byte(rename_card(board->tableaus[t].cards[0], suit_permutations[p]));
+            if (key < first_keys[p])
+                first_keys[p] = key;
+        }
+        if (first_keys[p] < best_first_key)
+            best_first_key = first_keys[p];
+    }
+
+    bool found = false;
+    for (int p = 0; p < NUM_SUIT_PERMUTATIONS; p++)
+    {
+        if (first_keys[p] != best_first_key)
+            continue;
+        PackedBoard candidate;
+        pack_renamed_board(board, suit_permutations[p], &candidate);
+        if (!found || memcmp(&candidate, canonical, sizeof(PackedBoard)) < 0)
+            *canonical = candidate;
+        found = true;
+    }
+    return true;
+}
+
+/**
+ * Returns a hash that is the same for every equivalent board.
+ * A board with cards in hand has no canonical form, so its Zobrist hash is returned instead.
+ */
+uint64_t get_canonical_hash(const Board *board)
+{
+    PackedBoard canonical;
+    if (!canonicalize_board(board, &canonical))
+        return board->hash;
+    return hash_packed_board(&canonical);
+}
+
+/**
+ * Checks if two boards are equivalent (see canonical.h).
+ */
+bool are_boards_equivalent(const Board *board1, const Board *board2)
+{
+    PackedBoard canonical1, canonical2;
+    return canonicalize_board(board1, &canonical1) && canonicalize_board(board2, &canonical2) &&
+           packed_boards_equal(&canonical1, &canonical2);
+}
@@ -0,0 +1,28 @@
+#ifndef CANONICAL_H
+#define CANONICAL_H
+
+#include "board.h"
+#include "packed.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file canonical.h
+ * Defines the canonical form of a position: one representative for every class
+ * of positions that play the same way.
+ *
+ * Two positions are equivalent if one turns into the other by
+ *   - reordering the tableaus (empty tableaus are interchangeable), and/or
+ *   - renaming the suits in a way that keeps colours apart: swapping the two red suits,
+ *     swapping the two black suits and/or swapping the red suits with the black suits
+ *     (8 renamings in all; the foundations are renamed along with the cards).
+ * The canonical form is the smallest packed board over all of these.
+ */
+
+#define NUM_SUIT_PERMUTATIONS 8
+
+bool canonicalize_board(const Board *board, PackedBoard *canonical);
+uint64_t get_canonical_hash(const Board *board);
+bool are_boards_equivalent(const Board *board1, const Board *board2);
+
+#endif // CANONICAL_H
@@ -60,7 +60,7 @@ bool get_card_color(Card card)
 Card get_next_card(Card card)
 {
     // Temporary variable to hold the "next" card
-    Card next_card;
+    Card next_card = {0};
 
     // If the rank is less than 13, add 1 to the rank to get the next card
     if (card.rank < 13)
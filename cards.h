@@ -3,6 +3,7 @@
 
 #include "constants.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @file cards.h
@@ -22,12 +23,14 @@ typedef enum
 
 /**
  * Represents a card with a rank and suit.
+ * The fields are bit-packed so that a card fits in a single byte,
+ * which keeps boards small enough to copy and hash cheaply.
  */
 typedef struct
 {
-    int rank;          // 1–13 (Ace=1, Jack=11, Queen=12, King=13)
-    bool is_face_down; // Indicates if the card is face down (true) or face up (false)
-    Suit suit;
+    uint8_t rank : 4;         // 1–13 (Ace=1, Jack=11, Queen=12, King=13), 0 for a "null" card
+    uint8_t suit : 2;         // Suit of the card (values from the Suit enum)
+    uint8_t is_face_down : 1; // Indicates if the card is face down (1) or face up (0)
 } Card;
 
 /**
@@ -36,7 +39,7 @@ typedef struct
 typedef struct
 {
     Card cards[FOUNDATION_SIZE]; // Array to hold cards in the foundation
-    int top;                     // Index of the top card
+    int8_t top;                  // Index of the top card
     Suit suit;                   // Suit of the foundation
 } Foundation;
 
@@ -46,9 +49,18 @@ typedef struct
 typedef struct
 {
     Card cards[TABLEAU_MAX_SIZE]; // Array to hold cards in the tableau
-    int top;                      // Index of the top card
+    int8_t top;                   // Index of the top card
 } Tableau;
 
+/**
+ * Returns a unique index from 0 to 51 for a valid card
+ * (suit by suit, Ace to King), used to index per-card tables.
+ */
+static inline int get_card_index(Card card)
+{
+    return card.suit * FOUNDATION_SIZE + card.rank - 1;
+}
+
 bool is_valid_card(Card card);
 bool compare_cards(Card card1, Card card2);
 bool is_lower_rank(Card card1, Card card2);
@@ -0,0 +1,86 @@
+#include "counters.h"
+#include "pile.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file counters.c
+ * Implements snapshots and export of the per-thread operation counters.
+ */
+
+_Thread_local OperationCounters thread_counters;
+
+/**
+ * Copies the calling thread's counters.
+ * Threads that want a total pass their snapshots to add_counters once they are done.
+ */
+void get_thread_counters(OperationCounters *snapshot)
+{
+    *snapshot = thread_counters;
+}
+
+/**
+ * Sets the calling thread's counters back to zero.
+ */
+void reset_thread_counters(void)
+{
+    memset(&thread_counters, 0, sizeof(thread_counters));
+}
+
+/**
+ * Adds counters (for example a snapshot from another thread) to a total.
+ */
+void add_counters(OperationCounters *total, const OperationCounters *counters)
+{
+    for (int i = 0; i < NUM_OPERATIONS; i++)
+    {
+        total->calls[i] += counters->calls[i];
+        total->cycles[i] += counters->cycles[i];
+        for (int j = 0; j < NUM_MOVE_STATUSES; j++)
+        {
+            total->rejections[i][j] += counters->rejections[i][j];
+        }
+    }
+    total->flips += counters->flips;
+    total->cards_returned += counters->cards_returned;
+    total->wins += counters->wins;
+}
+
+/**
+ * Writes the counters as one JSON object on one line.
+ * Rejection reasons that never happened are left out.
+ */
+void write_counters_json(FILE *file, const OperationCounters *counters)
+{
+    static const char *operation_names[NUM_OPERATIONS] = {"pick_up_cards", "place_cards_on_tableau",
+                                                          "place_card_on_foundation", "return_cards_to_tableau",
+                                                          "check_win_condition"};
+#ifdef YUKON_TIMING
+    bool timed = true;
+#else
+    bool timed = false;
+#endif
+    fprintf(file, "{\"timing\":%s,\"operations\":{", timed ? "true" : "false");
+    for (int i = 0; i < NUM_OPERATIONS; i++)
+    {
+        fprintf(file, "%s\"%s\":{\"calls\":%llu", i > 0 ? "," : "", operation_names[i],
+                (unsigned long long)counters->calls[i]);
+        if (timed)
+            fprintf(file, ",\"cycles\":%llu", (unsigned long long)counters->cycles[i]);
+        fprintf(file, ",\"rejections\":{");
+        bool first = true;
+        for (int j = 0; j < NUM_MOVE_STATUSES; j++)
+        {
+            if (counters->rejections[i][j] == 0)
+                continue;
+            fprintf(file, "%s\"%s\":%llu", first ? "" : ",", get_move_status_name((MoveStatus)j),
+                    (unsigned long long)counters->rejections[i][j]);
+            first = false;
+        }
+        fprintf(file, "}}");
+    }
+    fprintf(file, "},\"flips\":%llu,\"cards_returned\":%llu,\"wins\":%llu}\n", (unsigned long long)counters->flips,
+            (unsigned long long)counters->cards_returned, (unsigned long long)counters->wins);
+}
@@ -0,0 +1,89 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include "pile.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file counters.h
+ * Defines per-thread counters for the pile operations and the win check.
+ * Every thread counts into its own copy, so counting needs no locking.
+ * Build with -DYUKON_TIMING to also add up the time spent in each operation
+ * (in TSC cycles on x86, in nanoseconds elsewhere).
+ */
+
+#ifdef YUKON_TIMING
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+/**
+ * Enum representing the counted operations.
+ */
+typedef enum
+{
+    OPERATION_PICK_UP,             // pick_up_cards
+    OPERATION_PLACE_ON_TABLEAU,    // place_cards_on_tableau
+    OPERATION_PLACE_ON_FOUNDATION, // place_card_on_foundation
+    OPERATION_RETURN_CARDS,        // return_cards_to_tableau
+    OPERATION_WIN_CHECK,           // check_win_condition
+    NUM_OPERATIONS
+} Operation;
+
+/**
+ * Represents the counts of one thread, or of several threads added together.
+ */
+typedef struct
+{
+    uint64_t calls[NUM_OPERATIONS];
+    uint64_t rejections[NUM_OPERATIONS][NUM_MOVE_STATUSES]; // By reason (the MOVE_OK column stays 0)
+    uint64_t cycles[NUM_OPERATIONS];                         // Time spent, only counted with YUKON_TIMING
+    uint64_t flips;                                          // Face-down cards turned over automatically
+    uint64_t cards_returned;                                 // Cards put back by return_cards_to_tableau
+    uint64_t wins;                                           // Win checks that found a won game
+} OperationCounters;
+
+extern _Thread_local OperationCounters thread_counters;
+
+/**
+ * Returns the time stamp to pass to finish_operation (always 0 without YUKON_TIMING).
+ */
+static inline uint64_t start_operation(void)
+{
+#ifdef YUKON_TIMING
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Counts a finished call of an operation, and its status if it was rejected.
+ */
+static inline void finish_operation(Operation operation, MoveStatus status, uint64_t start)
+{
+    thread_counters.calls[operation]++;
+    thread_counters.rejections[operation][status] += (status != MOVE_OK);
+#ifdef YUKON_TIMING
+    thread_counters.cycles[operation] += start_operation() - start;
+#else
+    (void)start;
+#endif
+}
+
+void get_thread_counters(OperationCounters *snapshot);
+void reset_thread_counters(void);
+void add_counters(OperationCounters *total, const OperationCounters *counters);
+void write_counters_json(FILE *file, const OperationCounters *counters);
+
+#endif // COUNTERS_H
@@ -0,0 +1,128 @@
+#include "deadlock.h"
+#include "bitboard.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file deadlock.c
+ * Implements the dead position check.
+ *
+ * Every card must reach its foundation, in rank order within its suit,
+ * and only the top card of a tableau can go to a foundation.
+ * A card stuck above a card of its own tableau can leave it in only two ways:
+ * some card between them (or the card itself) is the bottom of a group moved to
+ * another tableau, or the cards above go to the foundations one by one.
+ *
+ * A card is pinned above a lower card of its tableau when none of the cards from just above
+ * the lower card up to it can ever be such a group bottom: none is a King, and each of
+ * their parents (the two opposite-colour cards one rank higher) is on a foundation or
+ * lies in the same stretch below it, where it can only be uncovered after the card has left.
+ * A pinned card must reach the foundations before the card it is pinned above.
+ * Together with the rank order of each suit this gives a "must go up before" relation,
+ * and if that relation has a cycle no order of play can win.
+ */
+
+/**
+ * Helper function to check whether a parent card can never hold the card at position l
+ * of tableau t while the cards from position i up stay together.
+ */
+static bool is_parent_unavailable(const Board *board, Card parent, int t, int i, int l)
+{
+    CardLocation location = find_card(board, parent);
+    if (location.pile >= LOCATION_FOUNDATION_BASE && location.pile < LOCATION_HAND)
+        return true;
+    return location.pile == t && location.position >= i && location.position < l;
+}
+
+/**
+ * Helper function to check whether the card at position l of tableau t can never be
+ * the bottom of a moved group while the cards from position i up stay together.
+ */
+static bool is_card_stuck(const Board *board, int t, int i, int l)
+{
+    Card card = board->tableaus[t].cards[l];
+    if (card.rank == 13)
+        return false; // A King can move to any tableau that becomes empty
+    // The parents are one rank higher, in the two suits of the other colour
+    Suit first = get_card_color(card) ? CLUBS : HEARTS;
+    for (int s = 0; s < 2; s++)
+    {
+        Card parent = {.rank = (uint8_t)(card.rank + 1), .suit = (uint8_t)(first + s)};
+        if (!is_parent_unavailable(board, parent, t, i, l))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Checks whether the board is provably lost.
+ * Returns false when in doubt, so a true result is always correct.
+ */
+bool is_position_dead(const Board *board)
+{
+    // Cards on the foundations
+    CardMask up = 0;
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        int suit = board->foundations[f].suit;
+        up |= ((1ULL << (board->foundations[f].top + 1)) - 1) << (suit * FOUNDATION_SIZE);
+    }
+
+    // The card just above a pinned stretch has at most one parent in it (the card below),
+    // so a pin can only start at a card with a parent on a foundation
+    CardMask starts = get_tableau_acceptors(up) & ~up;
+    // For each card in pinned_below, the cards pinned above it (the others are never read)
+    CardMask pinned_below = 0;
+    CardMask must_precede[DECK_SIZE];
+    while (starts != 0)
+    {
+        int index = __builtin_ctzll(starts);
+        starts &= starts - 1;
+        CardLocation location = board->locations[index];
+        if (location.pile >= NUM_TABLEAUS || location.position == 0)
+            continue;
+        // Every card pinned above the card below the start must go up before it
+        int t = location.pile, i = location.position - 1;
+        const Tableau *tableau = &board->tableaus[t];
+        int lower = get_card_index(tableau->cards[i]);
+        for (int j = i + 1; j <= tableau->top && is_card_stuck(board, t, i, j); j++)
+        {
+            if ((pinned_below & (1ULL << lower)) == 0)
+            {
+                pinned_below |= 1ULL << lower;
+                must_precede[lower] = 0;
+            }
+            must_precede[lower] |= get_card_mask(tableau->cards[j]);
+        }
+    }
+    if (pinned_below == 0)
+        return false;
+
+    // Look for a cycle: repeatedly take away cards with nothing left that must go up before them.
+    // The suit order is implied: a card follows the card one rank lower of its suit.
+    CardMask remaining = ~up & ((1ULL << DECK_SIZE) - 1);
+    bool progress = true;
+    while (remaining != 0 && progress)
+    {
+        progress = false;
+        CardMask cards = remaining;
+        while (cards != 0)
+        {
+            int b = __builtin_ctzll(cards);
+            cards &= cards - 1;
+            // The card one rank lower of the same suit (none for an Ace), and the cards pinned above
+            CardMask before = (b % FOUNDATION_SIZE == 0) ? 0 : 1ULL << (b - 1);
+            if ((pinned_below & (1ULL << b)) != 0)
+                before |= must_precede[b];
+            if ((before & remaining) == 0)
+            {
+                remaining &= ~(1ULL << b);
+                progress = true;
+            }
+        }
+    }
+    return remaining != 0;
+}
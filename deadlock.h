@@ -0,0 +1,14 @@
+#ifndef DEADLOCK_H
+#define DEADLOCK_H
+
+#include "board.h"
+#include <stdbool.h>
+
+/**
+ * @file deadlock.h
+ * Defines a static check that proves a position lost without searching it.
+ */
+
+bool is_position_dead(const Board *board);
+
+#endif // DEADLOCK_H
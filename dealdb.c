@@ -0,0 +1,365 @@
+#include "dealdb.h"
+#include "board.h"
+#include "packed.h"
+#include "solver.h"
+#include "transposition.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file dealdb.c
+ * Implements building, memory-mapping and looking up the deal database.
+ */
+
+_Static_assert(sizeof(DealDatabaseHeader) == DEAL_DATABASE_HEADER_SIZE, "DealDatabaseHeader must match its file size");
+_Static_assert(sizeof(DealRecord) == 72, "DealRecord must not contain padding");
+_Static_assert(sizeof(DealIndexHeader) % sizeof(uint64_t) == 0, "Index offsets must stay aligned");
+
+#define DEAL_DATABASE_TABLE_LOG2_ENTRIES 20 // Transposition table used while building (2^20 slots, 8 MB)
+#define DEAL_DATABASE_FLUSH_INTERVAL 256    // Records written between header updates
+
+/**
+ * Helper function to compute the difficulty of a won deal: log2 of the nodes searched,
+ * so each step up means the solver needed about twice as much search.
+ */
+static uint8_t get_difficulty(uint64_t nodes)
+{
+    uint8_t difficulty = 0;
+    while (nodes > 1)
+    {
+        nodes >>= 1;
+        difficulty++;
+    }
+    return difficulty;
+}
+
+/**
+ * Deals a seed and solves it with full information to fill in its record.
+ * The table may be NULL, in which case the solver allocates its own.
+ */
+void compute_deal_record(uint64_t seed, uint64_t max_nodes, TranspositionTable *table, DealRecord *record)
+{
+    static _Thread_local SolveResult result;
+    Board board;
+    initialize_board_from_seed(&board, seed);
+    memset(record, 0, sizeof(*record));
+    pack_board(&board, &record->board);
+    solve_board(&board, SOLVE_FULL_INFORMATION, max_nodes, table, &result);
+    record->status = (uint8_t)result.status;
+    record->nodes = result.nodes > UINT32_MAX ? UINT32_MAX : (uint32_t)result.nodes;
+    if (result.status == SOLVE_WON)
+    {
+        record->solution_length = (uint16_t)result.num_moves;
+        record->difficulty = get_difficulty(result.nodes);
+    }
+    else
+        record->difficulty = DEAL_UNSOLVED;
+}
+
+/**
+ * Helper function to write the header at the start of the file.
+ */
+static bool write_header(FILE *file, const DealDatabaseHeader *header)
+{
+    return fseek(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(*header), 1, file) == 1 && fflush(file) == 0;
+}
+
+/**
+ * Helper function to get the path of a database's difficulty index. The caller frees it.
+ */
+static char *get_index_path(const char *path)
+{
+    char *index_path = malloc(strlen(path) + sizeof(DEAL_INDEX_SUFFIX));
+    if (index_path != NULL)
+        strcat(strcpy(index_path, path), DEAL_INDEX_SUFFIX);
+    return index_path;
+}
+
+/**
+ * Helper function to write the difficulty index of a database from its records.
+ * The won deals are counting-sorted by difficulty, which keeps each group in seed order.
+ * The index is written to a temporary file and renamed over the old one, so readers
+ * see either the old index or the whole new one.
+ */
+static bool write_deal_index(const char *path)
+{
+    DealDatabase database;
+    if (!open_deal_database(&database, path))
+        return false;
+    DealIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = DEAL_INDEX_MAGIC;
+    header.version = DEAL_INDEX_VERSION;
+    header.first_seed = database.header->first_seed;
+    header.count = database.count;
+    // Count the deals of each difficulty, then turn the counts into start positions
+    for (uint64_t i = 0; i < database.count; i++)
+    {
+        if (database.records[i].difficulty <= DEAL_MAX_DIFFICULTY)
+            header.starts[database.records[i].difficulty + 1]++;
+    }
+    for (int d = 1; d <= DEAL_MAX_DIFFICULTY + 1; d++)
+        header.starts[d] += header.starts[d - 1];
+    uint64_t num_won = header.starts[DEAL_MAX_DIFFICULTY + 1];
+    uint64_t next[DEAL_MAX_DIFFICULTY + 1];
+    memcpy(next, header.starts, sizeof(next));
+    uint64_t *offsets = malloc((num_won > 0 ? num_won : 1) * sizeof(uint64_t));
+    char *index_path = get_index_path(path);
+    char *temporary_path = index_path != NULL ? malloc(strlen(index_path) + sizeof(".tmp")) : NULL;
+    bool ok = offsets != NULL && temporary_path != NULL;
+    for (uint64_t i = 0; ok && i < database.count; i++)
+    {
+        if (database.records[i].difficulty <= DEAL_MAX_DIFFICULTY)
+            offsets[next[database.records[i].difficulty]++] = i;
+    }
+    close_deal_database(&database);
+
+    FILE *file = NULL;
+    if (ok)
+    {
+        strcat(strcpy(temporary_path, index_path), ".tmp");
+        file = fopen(temporary_path, "wb");
+    }
+    ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+         fwrite(offsets, sizeof(uint64_t), (size_t)num_won, file) == num_won && fflush(file) == 0 &&
+         fsync(fileno(file)) == 0;
+    if (file != NULL)
+        ok = fclose(file) == 0 && ok;
+    ok = ok && rename(temporary_path, index_path) == 0;
+    if (!ok && file != NULL)
+        remove(temporary_path);
+    free(offsets);
+    free(index_path);
+    free(temporary_path);
+    return ok;
+}
+
+/**
+ * Builds or extends a database so it covers count seeds from first_seed.
+ * If the file already holds records for the same first seed, only the missing seeds are solved.
+ * The difficulty index is rewritten at the end.
+ * Returns false if the file cannot be written or belongs to a different range or node limit.
+ */
+bool build_deal_database(const char *path, uint64_t first_seed, uint64_t count, uint64_t max_nodes)
+{
+    DealDatabaseHeader header;
+    FILE *file = fopen(path, "r+b");
+    if (file != NULL)
+    {
+        // Extend an existing database
+        if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != DEAL_DATABASE_MAGIC ||
+            header.version != DEAL_DATABASE_VERSION || header.record_size != sizeof(DealRecord) ||
+            header.first_seed != first_seed || header.max_nodes != max_nodes)
+        {
+            fclose(file);
+            return false;
+        }
+    }
+    else
+    {
+        file = fopen(path, "w+b");
+        if (file == NULL)
+            return false;
+        memset(&header, 0, sizeof(header));
+        header.magic = DEAL_DATABASE_MAGIC;
+        header.version = DEAL_DATABASE_VERSION;
+        header.first_seed = first_seed;
+        header.record_size = sizeof(DealRecord);
+        header.max_nodes = (uint32_t)max_nodes;
+        if (!write_header(file, &header))
+        {
+            fclose(file);
+            return false;
+        }
+    }
+
+    TranspositionTable table;
+    if (!create_transposition_table(&table, DEAL_DATABASE_TABLE_LOG2_ENTRIES))
+    {
+        fclose(file);
+        return false;
+    }
+    // Records after header.count may be left over from an interrupted build, so overwrite them
+    bool ok = fseek(file, (long)(DEAL_DATABASE_HEADER_SIZE + header.count * sizeof(DealRecord)), SEEK_SET) == 0;
+    uint64_t written = header.count;
+    while (ok && written < count)
+    {
+        DealRecord record;
+        compute_deal_record(first_seed + written, max_nodes, &table, &record);
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+        written++;
+        if (ok && (written % DEAL_DATABASE_FLUSH_INTERVAL == 0 || written == count))
+        {
+            // Make the records durable (on disk, not just in the kernel) before the header counts them
+            header.count = written;
+            ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && write_header(file, &header) &&
+                 fseek(file, (long)(DEAL_DATABASE_HEADER_SIZE + written * sizeof(DealRecord)), SEEK_SET) == 0;
+        }
+    }
+    free_transposition_table(&table);
+    ok = fclose(file) == 0 && ok;
+    // Index the records once they are all written, so picks by difficulty need no scan
+    return ok && write_deal_index(path);
+}
+
+/**
+ * Helper function to memory-map the difficulty index of an open database.
+ * The index is left out unless it covers exactly the database's records,
+ * for example after an interrupted build.
+ */
+static void open_deal_index(DealDatabase *database, const char *path)
+{
+    char *index_path = get_index_path(path);
+    int fd = index_path != NULL ? open(index_path, O_RDONLY) : -1;
+    free(index_path);
+    if (fd < 0)
+        return;
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(DealIndexHeader))
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return;
+    const DealIndexHeader *index = map;
+    uint64_t num_won = index->starts[DEAL_MAX_DIFFICULTY + 1];
+    if (index->magic != DEAL_INDEX_MAGIC || index->version != DEAL_INDEX_VERSION ||
+        index->first_seed != database->header->first_seed || index->count != database->count ||
+        num_won > database->count || (size_t)st.st_size != sizeof(DealIndexHeader) + num_won * sizeof(uint64_t))
+    {
+        munmap(map, (size_t)st.st_size);
+        return;
+    }
+    database->index_map = map;
+    database->index_map_size = (size_t)st.st_size;
+    database->index = index;
+    database->index_offsets = (const uint64_t *)(index + 1);
+}
+
+/**
+ * Memory-maps a database for lookups, with its difficulty index if that is up to date.
+ * Returns false if the file cannot be mapped or is not a database.
+ */
+bool open_deal_database(DealDatabase *database, const char *path)
+{
+    memset(database, 0, sizeof(*database));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < DEAL_DATABASE_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping stays valid after the file is closed
+    if (map == MAP_FAILED)
+        return false;
+
+    const DealDatabaseHeader *header = map;
+    if (header->magic != DEAL_DATABASE_MAGIC || header->version != DEAL_DATABASE_VERSION ||
+        header->record_size != sizeof(DealRecord))
+    {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+    database->map = map;
+    database->map_size = (size_t)st.st_size;
+    database->header = header;
+    database->records = (const DealRecord *)((const uint8_t *)map + DEAL_DATABASE_HEADER_SIZE);
+    // Only trust records that are both counted by the header and present in the file
+    uint64_t present = (database->map_size - DEAL_DATABASE_HEADER_SIZE) / sizeof(DealRecord);
+    database->count = header->count < present ? header->count : present;
+    open_deal_index(database, path);
+    return true;
+}
+
+/**
+ * Unmaps a database.
+ */
+void close_deal_database(DealDatabase *database)
+{
+    if (database->map != NULL)
+        munmap(database->map, database->map_size);
+    if (database->index_map != NULL)
+        munmap(database->index_map, database->index_map_size);
+    memset(database, 0, sizeof(*database));
+}
+
+/**
+ * Looks up the record of a seed.
+ * Returns NULL if the seed is not in the database.
+ */
+const DealRecord *find_deal(const DealDatabase *database, uint64_t seed)
+{
+    uint64_t offset = seed - database->header->first_seed; // Wraps around for seeds below the range
+    if (offset >= database->count)
+        return NULL;
+    return &database->records[offset];
+}
+
+/**
+ * Finds a won deal with a difficulty in [min_difficulty, max_difficulty]: the first one
+ * from start_seed on, wrapping around to the start of the database.
+ * Passing a random start seed spreads the picks over the whole database.
+ * With the difficulty index this is a binary search in each difficulty of the range,
+ * touching a few pages; without it (an older database, or an interrupted build) the records are scanned.
+ * Returns false if no deal matches.
+ */
+bool find_deal_by_difficulty(const DealDatabase *database, uint8_t min_difficulty, uint8_t max_difficulty,
+                             uint64_t start_seed, uint64_t *seed)
+{
+    if (database->count == 0)
+        return false;
+    uint64_t start = (start_seed - database->header->first_seed) % database->count;
+    if (database->index != NULL)
+    {
+        if (max_difficulty > DEAL_MAX_DIFFICULTY)
+            max_difficulty = DEAL_MAX_DIFFICULTY;
+        bool found = false;
+        uint64_t best_distance = 0;
+        for (int d = min_difficulty; d <= max_difficulty; d++)
+        {
+            uint64_t low = database->index->starts[d], end = database->index->starts[d + 1];
+            if (low == end)
+                continue;
+            // First deal of this difficulty at or after the start, or else the first one overall
+            uint64_t high = end;
+            while (low < high)
+            {
+                uint64_t middle = low + (high - low) / 2;
+                if (database->index_offsets[middle] < start)
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+            uint64_t offset = database->index_offsets[low < end ? low : database->index->starts[d]];
+            uint64_t distance = (offset + database->count - start) % database->count;
+            if (!found || distance < best_distance)
+            {
+                found = true;
+                best_distance = distance;
+                *seed = database->header->first_seed + offset;
+            }
+        }
+        return found;
+    }
+    for (uint64_t i = 0; i < database->count; i++)
+    {
+        uint64_t offset = (start + i) % database->count;
+        const DealRecord *record = &database->records[offset];
+        if (record->difficulty != DEAL_UNSOLVED && record->difficulty >= min_difficulty &&
+            record->difficulty <= max_difficulty)
+        {
+            *seed = database->header->first_seed + offset;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,101 @@
+#ifndef DEALDB_H
+#define DEALDB_H
+
+#include "packed.h"
+#include "solver.h"
+#include "transposition.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file dealdb.h
+ * Defines the deal database: precomputed metadata for a range of seeds,
+ * stored as fixed-size records so a seed is found by its offset without parsing.
+ *
+ * A database file is laid out as:
+ *   header    DealDatabaseHeader (DEAL_DATABASE_HEADER_SIZE bytes)
+ *   records   one DealRecord per seed, starting at first_seed, in seed order
+ *
+ * Every build also writes a difficulty index next to it, at the database path plus DEAL_INDEX_SUFFIX:
+ *   header    DealIndexHeader
+ *   offsets   the seed offset of every won deal, grouped by difficulty, each group in seed order
+ * All fields are stored in the host's byte order (little-endian on supported machines).
+ */
+
+#define DEAL_DATABASE_MAGIC 0x42444B59 // "YKDB"
+#define DEAL_DATABASE_VERSION 1
+#define DEAL_DATABASE_HEADER_SIZE 64
+#define DEAL_UNSOLVED 0xFF // Difficulty of a deal the solver did not win
+#define DEAL_MAX_DIFFICULTY 63 // Highest difficulty of a won deal (log2 of a 64-bit node count)
+#define DEAL_INDEX_MAGIC 0x49444B59 // "YKDI"
+#define DEAL_INDEX_VERSION 1
+#define DEAL_INDEX_SUFFIX ".idx"
+
+/**
+ * Represents the start of a database file.
+ * count is only increased after the records it covers have been written,
+ * so a build that is interrupted leaves a valid database that can be extended.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t first_seed;
+    uint64_t count;     // Number of records in the file
+    uint32_t record_size;
+    uint32_t max_nodes; // Node limit the deals were solved with
+    uint8_t reserved[DEAL_DATABASE_HEADER_SIZE - 32];
+} DealDatabaseHeader;
+
+/**
+ * Represents the metadata of one deal.
+ */
+typedef struct
+{
+    PackedBoard board;        // The dealt layout
+    uint32_t nodes;           // Number of positions the full-information solver searched
+    uint16_t solution_length; // Number of moves in the solution (0 if not won)
+    uint8_t status;           // SolveStatus of the deal
+    uint8_t difficulty;       // log2 of the nodes searched to find the win, or DEAL_UNSOLVED
+} DealRecord;
+
+/**
+ * Represents the start of a difficulty index file.
+ * The won deals of difficulty d are offsets[starts[d]] to offsets[starts[d + 1] - 1],
+ * so the deals of a difficulty range are one contiguous run of offsets.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t first_seed;
+    uint64_t count; // Number of database records the index covers
+    uint64_t starts[DEAL_MAX_DIFFICULTY + 2];
+} DealIndexHeader;
+
+/**
+ * Represents an open, memory-mapped database.
+ */
+typedef struct
+{
+    void *map;
+    size_t map_size;
+    const DealDatabaseHeader *header;
+    const DealRecord *records;
+    uint64_t count;
+    void *index_map;               // Difficulty index, NULL if it is missing or does not match the records
+    size_t index_map_size;
+    const DealIndexHeader *index;
+    const uint64_t *index_offsets;
+} DealDatabase;
+
+void compute_deal_record(uint64_t seed, uint64_t max_nodes, TranspositionTable *table, DealRecord *record);
+bool build_deal_database(const char *path, uint64_t first_seed, uint64_t count, uint64_t max_nodes);
+bool open_deal_database(DealDatabase *database, const char *path);
+void close_deal_database(DealDatabase *database);
+const DealRecord *find_deal(const DealDatabase *database, uint64_t seed);
+bool find_deal_by_difficulty(const DealDatabase *database, uint8_t min_difficulty, uint8_t max_difficulty,
+                             uint64_t start_seed, uint64_t *seed);
+
+#endif // DEALDB_H
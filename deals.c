@@ -0,0 +1,126 @@
+/**
+ * @file deals.c
+ * Entry point for yukon-deals, which builds and queries a deal database (see dealdb.h).
+ *
+ * Usage:
+ *   yukon-deals build <database> <first_seed> <count> [--nodes N]
+ *   yukon-deals get <database> <seed>
+ *   yukon-deals find <database> <min_difficulty> <max_difficulty> [--start SEED]
+ *
+ * build solves the seeds that are not in the database yet and can be stopped and rerun at any time.
+ * get prints one seed's record and find prints the first won deal in a difficulty range.
+ */
+
+#include "board.h"
+#include "dealdb.h"
+#include "packed.h"
+#include "solver.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEALS_DEFAULT_NODES 1000000 // Default node limit per deal
+
+/**
+ * Helper function to print usage information.
+ */
+static void print_usage()
+{
+    fprintf(stderr, "Usage: yukon-deals build <database> <first_seed> <count> [--nodes N]\n"
+                    "       yukon-deals get <database> <seed>\n"
+                    "       yukon-deals find <database> <min_difficulty> <max_difficulty> [--start SEED]\n");
+}
+
+/**
+ * Helper function to print a record as one line.
+ */
+static void print_record(uint64_t seed, const DealRecord *record)
+{
+    const char *status_names[] = {"won", "lost", "unknown"};
+    printf("seed=%llu result=%s moves=%u nodes=%u difficulty=", (unsigned long long)seed,
+           status_names[record->status], record->solution_length, record->nodes);
+    if (record->difficulty == DEAL_UNSOLVED)
+        printf("none\n");
+    else
+        printf("%u\n", record->difficulty);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+    const char *command = argv[1];
+    const char *path = argv[2];
+
+    if (strcmp(command, "build") == 0 && argc >= 5)
+    {
+        uint64_t first_seed = strtoull(argv[3], NULL, 10);
+        uint64_t count = strtoull(argv[4], NULL, 10);
+        uint64_t max_nodes = DEALS_DEFAULT_NODES;
+        if (argc == 7 && strcmp(argv[5], "--nodes") == 0)
+            max_nodes = strtoull(argv[6], NULL, 10);
+        else if (argc != 5)
+        {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+        if (max_nodes > UINT32_MAX)
+        {
+            fprintf(stderr, "Error: --nodes must be at most %u.\n", UINT32_MAX);
+            return EXIT_FAILURE;
+        }
+        if (!build_deal_database(path, first_seed, count, max_nodes))
+        {
+            fprintf(stderr, "Error: Unable to build %s (is it a database for another range or node limit?).\n", path);
+            return EXIT_FAILURE;
+        }
+        return 0;
+    }
+
+    DealDatabase database;
+    if (!open_deal_database(&database, path))
+    {
+        fprintf(stderr, "Error: Unable to open deal database %s.\n", path);
+        return EXIT_FAILURE;
+    }
+    int status = 0;
+    if (strcmp(command, "get") == 0 && argc == 4)
+    {
+        uint64_t seed = strtoull(argv[3], NULL, 10);
+        const DealRecord *record = find_deal(&database, seed);
+        if (record != NULL)
+            print_record(seed, record);
+        else
+        {
+            fprintf(stderr, "Error: Seed %llu is not in the database.\n", (unsigned long long)seed);
+            status = EXIT_FAILURE;
+        }
+    }
+    else if (strcmp(command, "find") == 0 && (argc == 5 || argc == 7))
+    {
+        int min_difficulty = atoi(argv[3]), max_difficulty = atoi(argv[4]);
+        uint64_t start = database.header->first_seed;
+        if (argc == 7 && strcmp(argv[5], "--start") == 0)
+            start = strtoull(argv[6], NULL, 10);
+        uint64_t seed;
+        if (min_difficulty >= 0 && max_difficulty < DEAL_UNSOLVED && min_difficulty <= max_difficulty &&
+            find_deal_by_difficulty(&database, (uint8_t)min_difficulty, (uint8_t)max_difficulty, start, &seed))
+            print_record(seed, find_deal(&database, seed));
+        else
+        {
+            fprintf(stderr, "Error: No won deal with difficulty %d to %d.\n", min_difficulty, max_difficulty);
+            status = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        print_usage();
+        status = EXIT_FAILURE;
+    }
+    close_deal_database(&database);
+    return status;
+}
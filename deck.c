@@ -3,7 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "deck.h"
-#include <time.h>
+#include "rng.h"
 
 /**
  * @file deck.c
@@ -11,25 +11,17 @@
  */
 
 /**
- * Seeds the random number generator for shuffling the deck.
+ * Shuffles a deck of cards using the given random number generator.
+ * The same generator state always produces the same order.
  */
-void seed_deck_random()
-{
-    // Seed the random number generator with the current time to ensure different shuffle each run
-    srand(time(NULL));
-}
-
-/**
- * Shuffles a deck of cards.
- */
-void shuffle_deck(Card *deck)
+void shuffle_deck_with_rng(Card *deck, Rng *rng)
 {
     // Implements the Fisher-Yates shuffle algorithm to randomize the order of the deck
     // Loop through the deck from the last card to the first
     for (int i = DECK_SIZE - 1; i > 0; i--)
     {
         // Generate a random index from 0 to i
-        int j = rand() % (i + 1);
+        int j = (int)rng_below(rng, (uint32_t)(i + 1));
         // Swap the cards at indices i and j
         Card temp = deck[i];
         deck[i] = deck[j];
@@ -37,13 +29,21 @@ void shuffle_deck(Card *deck)
     }
 }
 
+/**
+ * Shuffles a deck of cards with a freshly seeded generator.
+ */
+void shuffle_deck(Card *deck)
+{
+    Rng rng;
+    rng_seed(&rng, random_seed());
+    shuffle_deck_with_rng(deck, &rng);
+}
+
 /**
  * Creates and returns a pointer to a new sorted deck.
  */
 Card *create_deck()
 {
-    // Seed the random number generator
-    seed_deck_random();
     // Allocate memory for the deck of cards
     Card *deck = malloc(DECK_SIZE * sizeof(Card));
     if (deck == NULL)
@@ -52,6 +52,16 @@ Card *create_deck()
         fprintf(stderr, "Error: Unable to allocate memory for deck.\n");
         exit(EXIT_FAILURE);
     }
+    fill_deck(deck);
+    // Return the pointer to the deck
+    return deck;
+}
+
+/**
+ * Fills an array of DECK_SIZE cards with a sorted deck.
+ */
+void fill_deck(Card *deck)
+{
     // Initialize the deck with cards in sorted order
     int index = 0;
     // Loop through each suit and rank to populate the deck
@@ -59,14 +69,11 @@ Card *create_deck()
     {
         for (int rank = 1; rank <= FOUNDATION_SIZE; rank++)
         {
-            deck[index].rank = rank;
-            deck[index].suit = (Suit)suit;
+            deck[index] = (Card){.rank = rank, .suit = (Suit)suit, .is_face_down = false};
             // Move to the next index in the deck
             index++;
         }
     }
-    // Return the pointer to the deck
-    return deck;
 }
 
 /**
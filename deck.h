@@ -2,6 +2,7 @@
 #define DECK_H
 
 #include "cards.h"
+#include "rng.h"
 
 /**
  * @file deck.h
@@ -9,7 +10,9 @@
  */
 
 void shuffle_deck(Card *deck);
+void shuffle_deck_with_rng(Card *deck, Rng *rng);
 Card *create_deck();
+void fill_deck(Card *deck);
 void free_deck(Card *deck);
 
 #endif // DECK_H
@@ -0,0 +1,75 @@
+/**
+ * @file engine.c
+ * Entry point for yukon-engine, which lets bots play over stdin and stdout with the protocol
+ * described in protocol.h.
+ *
+ * Usage: yukon-engine
+ *
+ * Commands may be pipelined: input is read in large blocks, every complete line in a block is
+ * handled, and the responses are written together with one flush per block, so a bot sending
+ * many commands at once pays for one read and one write instead of one per command.
+ * Nothing is redrawn; each command gets exactly one response line.
+ */
+
+#include "protocol.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ENGINE_INPUT_SIZE 65536 // Bytes read from stdin at a time; also the longest accepted line
+
+int main(void)
+{
+    static char input[ENGINE_INPUT_SIZE + 1];
+    static char output_buffer[ENGINE_INPUT_SIZE];
+    static Engine engine;
+    static Board board;
+    setvbuf(stdout, output_buffer, _IOFBF, sizeof(output_buffer));
+    init_engine(&engine, &board);
+
+    size_t length = 0;      // Bytes in input not handled yet
+    bool skipping = false;  // Whether the rest of an over-long line is being dropped
+    bool running = true;
+    while (running)
+    {
+        ssize_t received = read(STDIN_FILENO, input + length, ENGINE_INPUT_SIZE - length);
+        if (received <= 0)
+            break;
+        length += (size_t)received;
+
+        // Handle every complete line
+        char *line = input;
+        char *end;
+        while (running && (end = memchr(line, '\n', length - (size_t)(line - input))) != NULL)
+        {
+            *end = '\0';
+            if (skipping)
+                skipping = false;
+            else
+                running = handle_engine_command(&engine, line, stdout);
+            line = end + 1;
+        }
+        length -= (size_t)(line - input);
+        memmove(input, line, length);
+
+        // A full buffer without a newline is a line too long to be a command
+        if (length == ENGINE_INPUT_SIZE)
+        {
+            if (!skipping)
+                fputs("error line_too_long\n", stdout);
+            skipping = true;
+            length = 0;
+        }
+        fflush(stdout);
+    }
+
+    // A last command without a newline
+    if (running && length > 0 && !skipping)
+    {
+        input[length] = '\0';
+        handle_engine_command(&engine, input, stdout);
+    }
+    fflush(stdout);
+    return 0;
+}
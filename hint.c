@@ -0,0 +1,228 @@
+#include "hint.h"
+#include "board.h"
+#include "moves.h"
+#include "win.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @file hint.c
+ * Implements the hint engine: an iterative deepening search that keeps the best
+ * move of the deepest search finished before the time budget runs out.
+ *
+ * The search does not look at face-down cards: a move that turns a card over
+ * ends its line and is judged by the position it reveals, so hints never give
+ * away what a face-down card is.
+ */
+
+#define HINT_WIN_SCORE 1000000    // Score of a won position (less the number of moves to reach it)
+#define HINT_FOUNDATION_CARD 100  // Score of each card on a foundation
+#define HINT_FACE_DOWN_CARD 30    // Penalty for each face-down card
+#define HINT_COVERING_CARD 1      // Penalty for each card above a face-down card
+#define HINT_EMPTY_TABLEAU 20     // Score of each empty tableau
+#define HINT_CLOCK_INTERVAL 64    // Positions searched between clock checks
+
+/**
+ * Holds the state of one hint search.
+ */
+typedef struct
+{
+    Board board;                       // Working copy of the caller's board
+    struct timespec deadline;          // When the search must stop
+    uint64_t nodes;                    // Number of positions searched so far
+    bool stopped;                      // Whether the deadline was reached
+    bool cut;                          // Whether the current iteration stopped any line at the depth limit
+    uint64_t path[HINT_MAX_DEPTH + 1]; // Hashes of the positions on the current line
+} Hint;
+
+/**
+ * Helper function to check whether the deadline has passed.
+ * The clock is only read every HINT_CLOCK_INTERVAL positions.
+ */
+static bool is_out_of_time(Hint *hint)
+{
+    if (hint->stopped)
+        return true;
+    if (++hint->nodes % HINT_CLOCK_INTERVAL != 0)
+        return false;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    hint->stopped = now.tv_sec > hint->deadline.tv_sec ||
+                    (now.tv_sec == hint->deadline.tv_sec && now.tv_nsec >= hint->deadline.tv_nsec);
+    return hint->stopped;
+}
+
+/**
+ * Scores a position by what is visible: cards on the foundations,
+ * face-down cards still to turn over and how deeply they are buried, and empty tableaus.
+ */
+static int evaluate(const Board *board)
+{
+    if (check_win_condition((Board *)board))
+        return HINT_WIN_SCORE;
+    int score = 0;
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        score += HINT_FOUNDATION_CARD * (board->foundations[f].top + 1);
+    }
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        const Tableau *tableau = &board->tableaus[t];
+        if (tableau->top < 0)
+            score += HINT_EMPTY_TABLEAU;
+        // Face-down cards are always at the bottom of a tableau
+        for (int i = 0; i <= tableau->top && tableau->cards[i].is_face_down; i++)
+        {
+            score -= HINT_FACE_DOWN_CARD + HINT_COVERING_CARD * (tableau->top - i);
+        }
+    }
+    return score;
+}
+
+/**
+ * Helper function to generate the moves worth searching, best score_move first.
+ * Moves that can never help are left out.
+ */
+static int generate_ordered_moves(const Board *board, Move *moves)
+{
+    int scores[MAX_MOVES];
+    int num_moves = 0;
+    int num_generated = generate_moves(board, moves);
+    for (int i = 0; i < num_generated; i++)
+    {
+        Move move = moves[i];
+        int score = score_move(board, move);
+        if (score < 0)
+            continue;
+        // Insertion sort by descending score (move lists are short)
+        int j = num_moves++;
+        while (j > 0 && scores[j - 1] < score)
+        {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+            j--;
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+    return num_moves;
+}
+
+/**
+ * Helper function to check whether the current position already occurs earlier on the line.
+ */
+static bool is_repeated(const Hint *hint, int ply)
+{
+    for (int i = 0; i < ply; i++)
+    {
+        if (hint->path[i] == hint->board.hash)
+            return true;
+    }
+    return false;
+}
+
+static int search(Hint *hint, int depth, int ply);
+
+/**
+ * Helper function to score the position after a move, searching deeper unless the move
+ * turned a card over (the search does not know what the card is).
+ */
+static int search_move(Hint *hint, Move move, int depth, int ply)
+{
+    UndoEntry undo;
+    apply_move(&hint->board, move, &undo);
+    int score;
+    if (undo.flipped)
+        score = evaluate(&hint->board) - (ply + 1);
+    else
+        score = search(hint, depth - 1, ply + 1);
+    undo_move(&hint->board, &undo);
+    return score;
+}
+
+/**
+ * Searches the current position to the given depth.
+ * Returns the best score reachable, preferring shorter lines;
+ * stopping early is always allowed, so the score is at least that of the position itself.
+ */
+static int search(Hint *hint, int depth, int ply)
+{
+    int best = evaluate(&hint->board) - ply;
+    if (best >= HINT_WIN_SCORE - HINT_MAX_DEPTH - 1)
+        return best;
+    if (depth == 0)
+    {
+        hint->cut = true;
+        return best;
+    }
+    if (is_out_of_time(hint) || is_repeated(hint, ply))
+        return best;
+    hint->path[ply] = hint->board.hash;
+
+    Move moves[MAX_MOVES];
+    int num_moves = generate_ordered_moves(&hint->board, moves);
+    for (int i = 0; i < num_moves && !hint->stopped; i++)
+    {
+        int score = search_move(hint, moves[i], depth, ply);
+        if (score > best)
+            best = score;
+    }
+    return best;
+}
+
+/**
+ * Suggests a move for the board, searching deeper for as long as the budget allows.
+ * The board is copied and never changed.
+ * Returns false if there is no move worth making.
+ */
+bool suggest_move(const Board *board, uint64_t budget_us, Move *move)
+{
+    Hint hint;
+    hint.board = *board;
+    hint.nodes = 0;
+    hint.stopped = false;
+    clock_gettime(CLOCK_MONOTONIC, &hint.deadline);
+    uint64_t deadline_ns = (uint64_t)hint.deadline.tv_nsec + budget_us * 1000;
+    hint.deadline.tv_sec += (time_t)(deadline_ns / 1000000000);
+    hint.deadline.tv_nsec = (long)(deadline_ns % 1000000000);
+
+    Move moves[MAX_MOVES];
+    int num_moves = generate_ordered_moves(&hint.board, moves);
+    if (num_moves == 0)
+        return false;
+    hint.path[0] = hint.board.hash;
+
+    // The best move of the last finished iteration; before any, the best by score_move
+    int best_index = 0;
+    for (int depth = 1; depth <= HINT_MAX_DEPTH; depth++)
+    {
+        hint.cut = false;
+        int iteration_best = 0, iteration_score = 0;
+        // Search the previous best move first, as it is the most likely to stay the best
+        Move first = moves[best_index];
+        moves[best_index] = moves[0];
+        moves[0] = first;
+        best_index = 0;
+        for (int i = 0; i < num_moves; i++)
+        {
+            int score = search_move(&hint, moves[i], depth, 0);
+            if (hint.stopped)
+                break;
+            if (i == 0 || score > iteration_score)
+            {
+                iteration_best = i;
+                iteration_score = score;
+            }
+        }
+        // Always keep the first iteration, so there is an answer even with no budget
+        if (hint.stopped && depth > 1)
+            break;
+        best_index = iteration_best;
+        // Deeper searches would see nothing new if no line reached the depth limit
+        if (hint.stopped || !hint.cut || iteration_score >= HINT_WIN_SCORE - HINT_MAX_DEPTH - 1)
+            break;
+    }
+    *move = moves[best_index];
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef HINT_H
+#define HINT_H
+
+#include "board.h"
+#include "moves.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file hint.h
+ * Defines the hint engine, which suggests a move within a time budget.
+ */
+
+/**
+ * Deepest search the hint engine will try, in moves.
+ */
+#define HINT_MAX_DEPTH 64
+
+bool suggest_move(const Board *board, uint64_t budget_us, Move *move);
+
+#endif // HINT_H
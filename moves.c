@@ -0,0 +1,329 @@
+#include "moves.h"
+#include "board.h"
+#include "rule_tables.h"
+#include "constants.h"
+#include "zobrist.h"
+#include "bitboard.h"
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @file moves.c
+ * Implements move validation, legal move generation and in-place make/unmake of moves.
+ * The checks mirror pick_up_cards, place_cards_on_tableau and
+ * place_card_on_foundation in pile.c, but never touch the board.
+ * The rules are looked up in the tables generated from rules.c (see rule_tables.h).
+ */
+
+/**
+ * Helper function to check if a card can be placed on a tableau.
+ * Follows the same rules as place_cards_on_tableau.
+ */
+static bool can_place_card_on_tableau(const Tableau *tableau, Card card)
+{
+    // An empty tableau only accepts a King
+    if (tableau->top < 0)
+        return card.rank == 13;
+    Card top_card = tableau->cards[tableau->top];
+    // Cards can never go onto a face-down card
+    if (top_card.is_face_down)
+        return false;
+    return fits_on_tableau(card, top_card);
+}
+
+/**
+ * Helper function to check if a card can be placed on a foundation.
+ * Follows the same rules as place_card_on_foundation.
+ */
+static bool can_place_card_on_foundation(const Foundation *foundation, Card card)
+{
+    // Use a "null" card for an empty foundation, like place_card_on_foundation does
+    Card top_card = (foundation->top >= 0) ? foundation->cards[foundation->top] : (Card){0};
+    return fits_on_foundation(card, top_card, foundation->suit);
+}
+
+/**
+ * Checks if a move is legal on the given board.
+ * Moving cards back onto their own tableau is never considered legal.
+ */
+bool is_legal_move(const Board *board, Move move)
+{
+    // Check if the source tableau index is valid
+    if (move.from >= NUM_TABLEAUS)
+        return false;
+    const Tableau *source = &board->tableaus[move.from];
+
+    // Check if there are enough cards to pick up
+    if (move.count == 0 || move.count > source->top + 1)
+        return false;
+
+    // All the moved cards must be face-up
+    int start = source->top - move.count + 1;
+    for (int i = start; i <= source->top; i++)
+    {
+        if (source->cards[i].is_face_down)
+            return false;
+    }
+
+    if (move.type == MOVE_TO_TABLEAU)
+    {
+        if (move.to >= NUM_TABLEAUS || move.to == move.from)
+            return false;
+        // Yukon rule: only the first moved card has to fit on the destination
+        return can_place_card_on_tableau(&board->tableaus[move.to], source->cards[start]);
+    }
+    if (move.type == MOVE_TO_FOUNDATION)
+    {
+        // Only a single card can go to a foundation
+        if (move.to >= NUM_SUITS || move.count != 1)
+            return false;
+        return can_place_card_on_foundation(&board->foundations[move.to], source->cards[start]);
+    }
+    return false;
+}
+
+/**
+ * Writes every legal move on the board to the moves array
+ * (which must hold at least MAX_MOVES entries) and returns the number of moves.
+ * Foundation moves are listed first for each source tableau.
+ */
+int generate_moves(const Board *board, Move *moves)
+{
+    // Work out with masks which cards each destination accepts,
+    // so candidate moves are found without a rule call per card pair (see bitboard.h)
+    Bitboard bitboard;
+    build_bitboard(board, &bitboard);
+    CardMask acceptors[NUM_TABLEAUS];
+    CardMask any_acceptor = 0;
+    for (int to = 0; to < NUM_TABLEAUS; to++)
+    {
+        // Only a King can go on an empty tableau
+        acceptors[to] = (bitboard.empty_tableaus & (1 << to)) ? KINGS_MASK : get_tableau_acceptors(bitboard.tableau_tops[to]);
+        any_acceptor |= acceptors[to];
+    }
+    // Face-up cards that fit on some tableau, and top cards that fit on their foundation
+    CardMask movable = bitboard.face_up & any_acceptor;
+    CardMask to_foundation = bitboard.tops & bitboard.foundation_next;
+
+    int num_moves = 0;
+    for (int from = 0; from < NUM_TABLEAUS; from++)
+    {
+        const Tableau *source = &board->tableaus[from];
+        if (source->top < 0)
+            continue;
+
+        // Only the top card can go to a foundation
+        if (to_foundation & bitboard.tableau_tops[from])
+        {
+            int f = bitboard.foundation_by_suit[source->cards[source->top].suit];
+            moves[num_moves++] = (Move){MOVE_TO_FOUNDATION, (uint8_t)from, (uint8_t)f, 1};
+        }
+
+        // Any face-up card can be moved together with all the cards above it,
+        // but most tableaus have no card that fits anywhere
+        CardMask candidates = bitboard.tableau_face_up[from] & movable;
+        for (int i = source->top; candidates != 0; i--)
+        {
+            CardMask card = get_card_mask(source->cards[i]);
+            if ((candidates & card) == 0)
+                continue;
+            candidates &= ~card;
+            uint8_t count = (uint8_t)(source->top - i + 1);
+            for (int to = 0; to < NUM_TABLEAUS; to++)
+            {
+                // Never back onto the source itself
+                if (to != from && (acceptors[to] & card))
+                    moves[num_moves++] = (Move){MOVE_TO_TABLEAU, (uint8_t)from, (uint8_t)to, count};
+            }
+        }
+    }
+    return num_moves;
+}
+
+/**
+ * Scores a legal move by how promising it looks (higher is better),
+ * for move ordering in searches and for heuristic playouts.
+ * Returns a negative score for moves that can never help.
+ * Only uses information a player can see, so it never peeks at face-down cards.
+ */
+int score_move(const Board *board, Move move)
+{
+    const Tableau *source = &board->tableaus[move.from];
+    int start = source->top - move.count + 1;
+    Card card = source->cards[start];
+
+    // Foundation moves first, lowest ranks first
+    if (move.type == MOVE_TO_FOUNDATION)
+        return 1000 - card.rank;
+
+    // Moving a whole tableau onto an empty tableau changes nothing
+    if (start == 0 && board->tableaus[move.to].top < 0)
+        return -1;
+
+    // Turning over a face-down card gives new options
+    if (start > 0 && source->cards[start - 1].is_face_down)
+        return 500;
+    // Emptying a tableau makes room for a King
+    if (start == 0)
+        return 400;
+    // Moving a group off a card it already fits on only helps in special cases, so try it last
+    Card below = source->cards[start - 1];
+    if (fits_on_tableau(card, below))
+        return 0;
+    return 100;
+}
+
+/**
+ * Applies a move directly to the board without going through the hand.
+ * Returns false and leaves the board unchanged if the move is illegal.
+ * On success the undo entry (if not NULL) records what is needed to take the move back.
+ */
+bool apply_move(Board *board, Move move, UndoEntry *undo)
+{
+    if (!is_legal_move(board, move))
+        return false;
+
+    Tableau *source = &board->tableaus[move.from];
+    int start = source->top - move.count + 1;
+    // Only the bottom moved card changes what it rests on, so it is the only one rehashed
+    Card bottom_card = source->cards[start];
+    board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(source->cards, start, ZOBRIST_TABLEAU_BOTTOM));
+
+    if (move.type == MOVE_TO_TABLEAU)
+    {
+        // Move the whole group in one copy
+        Tableau *destination = &board->tableaus[move.to];
+        board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(destination->cards, destination->top + 1, ZOBRIST_TABLEAU_BOTTOM));
+        memcpy(&destination->cards[destination->top + 1], &source->cards[start], move.count * sizeof(Card));
+        int destination_start = destination->top + 1;
+        for (int i = 0; i < move.count; i++)
+        {
+            set_card_location(board, source->cards[start + i], move.to, destination_start + i);
+        }
+        destination->top += move.count;
+    }
+    else
+    {
+        Foundation *foundation = &board->foundations[move.to];
+        board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(foundation->cards, foundation->top + 1, ZOBRIST_FOUNDATION_BASE + move.to));
+        foundation->cards[++foundation->top] = bottom_card;
+        set_card_location(board, bottom_card, LOCATION_FOUNDATION_BASE + move.to, foundation->top);
+    }
+    source->top -= move.count;
+
+    // Turn a face-down card face-up if the move uncovered it (as pick_up_cards does).
+    // The moved cards are all face-up, so the destination never needs turning.
+    bool flipped = false;
+    if (source->top >= 0 && source->cards[source->top].is_face_down)
+    {
+        source->cards[source->top].is_face_down = false;
+        board->hash ^= get_zobrist_key(source->cards[source->top], ZOBRIST_FACE_DOWN);
+        flipped = true;
+    }
+
+    if (undo != NULL)
+    {
+        undo->move = move;
+        undo->flipped = flipped;
+        undo->automatic = false;
+    }
+    return true;
+}
+
+/**
+ * Takes back a move made by apply_move, including turning an uncovered card face-down again.
+ * Moves must be undone in the reverse order they were applied.
+ */
+void undo_move(Board *board, const UndoEntry *undo)
+{
+    Move move = undo->move;
+    Tableau *source = &board->tableaus[move.from];
+
+    // Turn the uncovered card face-down again before covering it
+    if (undo->flipped)
+    {
+        source->cards[source->top].is_face_down = true;
+        board->hash ^= get_zobrist_key(source->cards[source->top], ZOBRIST_FACE_DOWN);
+    }
+
+    Card bottom_card;
+    if (move.type == MOVE_TO_TABLEAU)
+    {
+        Tableau *destination = &board->tableaus[move.to];
+        int start = destination->top - move.count + 1;
+        bottom_card = destination->cards[start];
+        board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(destination->cards, start, ZOBRIST_TABLEAU_BOTTOM));
+        memcpy(&source->cards[source->top + 1], &destination->cards[start], move.count * sizeof(Card));
+        int source_start = source->top + 1;
+        for (int i = 0; i < move.count; i++)
+        {
+            set_card_location(board, destination->cards[start + i], move.from, source_start + i);
+        }
+        destination->top -= move.count;
+    }
+    else
+    {
+        Foundation *foundation = &board->foundations[move.to];
+        bottom_card = foundation->cards[foundation->top];
+        board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(foundation->cards, foundation->top, ZOBRIST_FOUNDATION_BASE + move.to));
+        source->cards[source->top + 1] = foundation->cards[foundation->top--];
+        set_card_location(board, bottom_card, move.from, source->top + 1);
+    }
+    board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(source->cards, source->top + 1, ZOBRIST_TABLEAU_BOTTOM));
+    source->top += move.count;
+}
+
+/**
+ * Initializes an empty undo stack.
+ */
+void init_undo_stack(UndoStack *stack)
+{
+    stack->start = 0;
+    stack->size = 0;
+}
+
+/**
+ * Pushes an undo entry. When the stack is full the oldest entry is dropped.
+ */
+void push_undo_entry(UndoStack *stack, const UndoEntry *undo)
+{
+    if (stack->size == UNDO_STACK_SIZE)
+    {
+        // Drop the oldest entry to make room
+        stack->start = (stack->start + 1) % UNDO_STACK_SIZE;
+        stack->size--;
+    }
+    stack->entries[(stack->start + stack->size) % UNDO_STACK_SIZE] = *undo;
+    stack->size++;
+}
+
+/**
+ * Pops the most recent undo entry. Returns false if the stack is empty.
+ */
+bool pop_undo_entry(UndoStack *stack, UndoEntry *undo)
+{
+    if (stack->size == 0)
+        return false;
+    stack->size--;
+    *undo = stack->entries[(stack->start + stack->size) % UNDO_STACK_SIZE];
+    return true;
+}
+
+/**
+ * Takes back the last move a player made together with the cards auto-played after it,
+ * so the board is as it was before that move.
+ * Returns the number of entries undone (0 if the stack is empty).
+ */
+int undo_last_move(UndoStack *stack, Board *board)
+{
+    int num_undone = 0;
+    UndoEntry undo;
+    while (pop_undo_entry(stack, &undo))
+    {
+        undo_move(board, &undo);
+        num_undone++;
+        if (!undo.automatic)
+            break;
+    }
+    return num_undone;
+}
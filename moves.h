@@ -0,0 +1,78 @@
+#ifndef MOVES_H
+#define MOVES_H
+
+#include "board.h"
+#include "constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file moves.h
+ * Defines the move type and the functions for listing legal moves
+ * without changing the board.
+ */
+
+/**
+ * Upper bound on the number of legal moves in any position:
+ * every card moving to every other tableau, plus one foundation move per tableau.
+ */
+#define MAX_MOVES (DECK_SIZE * (NUM_TABLEAUS - 1) + NUM_TABLEAUS)
+
+/**
+ * Enum representing where a move puts its cards.
+ */
+typedef enum
+{
+    MOVE_TO_TABLEAU,
+    MOVE_TO_FOUNDATION
+} MoveType;
+
+/**
+ * Represents a move of a group of cards from the top of a tableau.
+ * Matches pick_up_cards(from, count) followed by
+ * place_cards_on_tableau(to) or place_card_on_foundation(to).
+ */
+typedef struct
+{
+    uint8_t type;  // MoveType of the move
+    uint8_t from;  // Index of the source tableau
+    uint8_t to;    // Index of the destination tableau or foundation
+    uint8_t count; // Number of cards moved (always 1 for foundation moves)
+} Move;
+
+/**
+ * Records what apply_move changed, so undo_move can restore the board exactly.
+ */
+typedef struct
+{
+    Move move;    // The move that was applied
+    bool flipped;   // Whether the move turned a face-down card on the source tableau face-up
+    bool automatic; // Whether auto-play made the move, so undo_last_move takes it back with the move before it
+} UndoEntry;
+
+/**
+ * Number of moves the undo stack remembers. When it is full the oldest move is dropped.
+ */
+#define UNDO_STACK_SIZE 256
+
+/**
+ * Represents a bounded history of applied moves, used for player undo.
+ */
+typedef struct
+{
+    UndoEntry entries[UNDO_STACK_SIZE]; // Ring buffer of undo entries
+    int start;                          // Index of the oldest entry
+    int size;                           // Number of entries in the stack
+} UndoStack;
+
+bool is_legal_move(const Board *board, Move move);
+int generate_moves(const Board *board, Move *moves);
+int score_move(const Board *board, Move move);
+bool apply_move(Board *board, Move move, UndoEntry *undo);
+void undo_move(Board *board, const UndoEntry *undo);
+void init_undo_stack(UndoStack *stack);
+void push_undo_entry(UndoStack *stack, const UndoEntry *undo);
+bool pop_undo_entry(UndoStack *stack, UndoEntry *undo);
+int undo_last_move(UndoStack *stack, Board *board);
+
+#endif // MOVES_H
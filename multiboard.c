@@ -0,0 +1,203 @@
+#include "multiboard.h"
+#include "bitboard.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include "moves.h"
+#include "rule_tables.h"
+#include "zobrist.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file multiboard.c
+ * Implements batched move validation and application over a struct-of-arrays batch of games.
+ * The placement rules come from the tables generated from rules.c (see rule_tables.h),
+ * so checking a move in a lane costs a few loads and no calls.
+ */
+
+/**
+ * Empties a batch of num_lanes games.
+ * Lanes must be loaded with load_lane before use.
+ */
+void init_multiboard(MultiBoard *batch, int num_lanes)
+{
+    if (num_lanes < 1)
+        num_lanes = 1;
+    if (num_lanes > MULTIBOARD_MAX_LANES)
+        num_lanes = MULTIBOARD_MAX_LANES;
+    batch->num_lanes = num_lanes;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+        {
+            batch->tableau_tops[t][lane] = -1;
+            batch->first_face_up[t][lane] = 0;
+        }
+    }
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+            batch->foundation_tops[f][lane] = -1;
+    }
+}
+
+/**
+ * Copies a board into a lane.
+ * Returns false (and leaves the lane alone) if the lane is out of range or the board has cards in hand.
+ */
+bool load_lane(MultiBoard *batch, int lane, const Board *board)
+{
+    if (lane < 0 || lane >= batch->num_lanes || board->hand.size != 0)
+        return false;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        const Tableau *tableau = &board->tableaus[t];
+        int first_face_up = tableau->top + 1;
+        for (int i = tableau->top; i >= 0 && !tableau->cards[i].is_face_down; i--)
+            first_face_up = i;
+        for (int i = 0; i <= tableau->top; i++)
+        {
+            Card card = tableau->cards[i];
+            card.is_face_down = false; // Kept as first_face_up instead
+            batch->tableau_cards[t][i][lane] = card;
+        }
+        batch->tableau_tops[t][lane] = tableau->top;
+        batch->first_face_up[t][lane] = (int8_t)(tableau->top < 0 ? 0 : first_face_up);
+    }
+    for (int f = 0; f < NUM_SUITS; f++)
+        batch->foundation_tops[f][lane] = board->foundations[f].top;
+    return true;
+}
+
+/**
+ * Copies a lane back into a board, with its hash and card locations.
+ */
+void store_lane(const MultiBoard *batch, int lane, Board *board)
+{
+    reset_board(board);
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        Tableau *tableau = &board->tableaus[t];
+        tableau->top = batch->tableau_tops[t][lane];
+        for (int i = 0; i <= tableau->top; i++)
+        {
+            tableau->cards[i] = batch->tableau_cards[t][i][lane];
+            tableau->cards[i].is_face_down = i < batch->first_face_up[t][lane];
+        }
+    }
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        Foundation *foundation = &board->foundations[f];
+        foundation->top = batch->foundation_tops[f][lane];
+        for (int i = 0; i <= foundation->top; i++)
+            foundation->cards[i] = (Card){.rank = (uint8_t)(i + 1), .suit = (uint8_t)f};
+    }
+    rebuild_card_locations(board);
+    board->hash = compute_board_hash(board);
+}
+
+/**
+ * Helper function to check a move in one lane, with the same rules as is_legal_move.
+ */
+static inline bool is_lane_move_legal(const MultiBoard *batch, Move move, int lane)
+{
+    if (move.from >= NUM_TABLEAUS || move.count == 0)
+        return false;
+    // All the moved cards must be face-up (this also rejects moving more cards than there are)
+    int start = batch->tableau_tops[move.from][lane] - move.count + 1;
+    if (start < batch->first_face_up[move.from][lane])
+        return false;
+    CardMask moved = get_card_mask(batch->tableau_cards[move.from][start][lane]);
+
+    if (move.type == MOVE_TO_TABLEAU)
+    {
+        if (move.to >= NUM_TABLEAUS || move.to == move.from)
+            return false;
+        int top = batch->tableau_tops[move.to][lane];
+        if (top >= 0 && top < batch->first_face_up[move.to][lane])
+            return false; // Nothing goes onto a face-down card
+        int row = top < 0 ? DECK_SIZE : get_card_index(batch->tableau_cards[move.to][top][lane]);
+        return (tableau_rule_table[row] & moved) != 0;
+    }
+    if (move.type == MOVE_TO_FOUNDATION)
+    {
+        if (move.to >= NUM_SUITS || move.count != 1)
+            return false;
+        // Foundation f holds suit f from the Ace up, so its top card is known from its size
+        int top = batch->foundation_tops[move.to][lane];
+        int row = top < 0 ? DECK_SIZE : move.to * FOUNDATION_SIZE + top;
+        return (foundation_rule_table[move.to][row] & moved) != 0;
+    }
+    return false;
+}
+
+/**
+ * Checks moves[lane] in every given lane without changing the batch.
+ * moves is indexed by lane. Returns the lanes whose move is legal.
+ */
+LaneMask validate_moves(const MultiBoard *batch, const Move *moves, LaneMask lanes)
+{
+    LaneMask legal = 0;
+    for (LaneMask rest = lanes & get_all_lanes(batch); rest != 0; rest &= rest - 1)
+    {
+        int lane = __builtin_ctzll(rest);
+        legal |= (LaneMask)is_lane_move_legal(batch, moves[lane], lane) << lane;
+    }
+    return legal;
+}
+
+/**
+ * Applies moves[lane] in every given lane where it is legal, turning over uncovered face-down cards.
+ * Returns the lanes that moved. If flipped is not NULL, the lanes where a card was turned over
+ * are stored in it.
+ */
+LaneMask apply_moves(MultiBoard *batch, const Move *moves, LaneMask lanes, LaneMask *flipped)
+{
+    LaneMask applied = validate_moves(batch, moves, lanes);
+    LaneMask flips = 0;
+    for (LaneMask rest = applied; rest != 0; rest &= rest - 1)
+    {
+        int lane = __builtin_ctzll(rest);
+        Move move = moves[lane];
+        int start = batch->tableau_tops[move.from][lane] - move.count + 1;
+        if (move.type == MOVE_TO_TABLEAU)
+        {
+            int top = batch->tableau_tops[move.to][lane];
+            for (int i = 0; i < move.count; i++)
+                batch->tableau_cards[move.to][top + 1 + i][lane] = batch->tableau_cards[move.from][start + i][lane];
+            batch->tableau_tops[move.to][lane] = (int8_t)(top + move.count);
+        }
+        else
+        {
+            batch->foundation_tops[move.to][lane]++;
+        }
+        batch->tableau_tops[move.from][lane] = (int8_t)(start - 1);
+        // The moved cards started at the lowest face-up card, so the card below is face-down
+        if (start > 0 && start == batch->first_face_up[move.from][lane])
+        {
+            batch->first_face_up[move.from][lane] = (int8_t)(start - 1);
+            flips |= 1ULL << lane;
+        }
+    }
+    if (flipped != NULL)
+        *flipped = flips;
+    return applied;
+}
+
+/**
+ * Returns the lanes whose games are won (every foundation complete).
+ */
+LaneMask get_won_lanes(const MultiBoard *batch)
+{
+    LaneMask won = 0;
+    for (int lane = 0; lane < batch->num_lanes; lane++)
+    {
+        bool complete = true;
+        for (int f = 0; f < NUM_SUITS; f++)
+            complete = complete && batch->foundation_tops[f][lane] == FOUNDATION_SIZE - 1;
+        won |= (LaneMask)complete << lane;
+    }
+    return won;
+}
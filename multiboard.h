@@ -0,0 +1,56 @@
+#ifndef MULTIBOARD_H
+#define MULTIBOARD_H
+
+#include "bitboard.h"
+#include "board.h"
+#include "constants.h"
+#include "moves.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file multiboard.h
+ * Defines a batch of up to 64 games stored as a struct of arrays,
+ * for moving many games in lockstep (random playouts, or one candidate move
+ * tried in many determinized worlds).
+ * Each game is a lane. The lane is the innermost index of every array, so the same pile
+ * position of all the games is contiguous in memory and a call handles a whole batch.
+ */
+
+#define MULTIBOARD_MAX_LANES 64
+
+/**
+ * Set of lanes, one bit per lane.
+ */
+typedef uint64_t LaneMask;
+
+/**
+ * Represents a batch of games.
+ * Foundations only store their size: foundation f holds suit f from the Ace up.
+ * Face-down cards are the cards below first_face_up in each tableau.
+ */
+typedef struct
+{
+    Card tableau_cards[NUM_TABLEAUS][TABLEAU_MAX_SIZE][MULTIBOARD_MAX_LANES];
+    int8_t tableau_tops[NUM_TABLEAUS][MULTIBOARD_MAX_LANES];  // Index of the top card, -1 if empty
+    int8_t first_face_up[NUM_TABLEAUS][MULTIBOARD_MAX_LANES]; // Index of the lowest face-up card
+    int8_t foundation_tops[NUM_SUITS][MULTIBOARD_MAX_LANES];  // Index of the top card, -1 if empty
+    int num_lanes;
+} MultiBoard;
+
+void init_multiboard(MultiBoard *batch, int num_lanes);
+bool load_lane(MultiBoard *batch, int lane, const Board *board);
+void store_lane(const MultiBoard *batch, int lane, Board *board);
+LaneMask validate_moves(const MultiBoard *batch, const Move *moves, LaneMask lanes);
+LaneMask apply_moves(MultiBoard *batch, const Move *moves, LaneMask lanes, LaneMask *flipped);
+LaneMask get_won_lanes(const MultiBoard *batch);
+
+/**
+ * Returns the mask of every lane in the batch.
+ */
+static inline LaneMask get_all_lanes(const MultiBoard *batch)
+{
+    return batch->num_lanes == MULTIBOARD_MAX_LANES ? ~0ULL : (1ULL << batch->num_lanes) - 1;
+}
+
+#endif // MULTIBOARD_H
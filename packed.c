@@ -0,0 +1,106 @@
+#include "packed.h"
+#include "board.h"
+#include "constants.h"
+#include "zobrist.h"
+#include <string.h>
+
+/**
+ * @file packed.c
+ * Implements conversion between the game board and its packed form.
+ */
+
+_Static_assert(sizeof(Card) == 1, "Card must fit in one byte");
+_Static_assert(sizeof(PackedBoard) == 64, "PackedBoard must fit in one cache line");
+
+/**
+ * Packs a board into its compact form.
+ * Returns false if the board cannot be packed (cards are still in the hand).
+ */
+bool pack_board(const Board *board, PackedBoard *packed)
+{
+    // A board in the middle of a move has no stable layout to store
+    if (board->hand.size != 0)
+        return false;
+
+    // Clear the packed board so unused bytes compare and hash equal
+    memset(packed, 0, sizeof(PackedBoard));
+
+    int index = 0;
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        const Tableau *tableau = &board->tableaus[i];
+        packed->tableau_sizes[i] = (uint8_t)(tableau->top + 1);
+        for (int j = 0; j <= tableau->top; j++)
+        {
+            Card card = tableau->cards[j];
+            // Copy the fields one by one so the unused bit of the byte is always 0
+            packed->cards[index++] = (Card){.rank = card.rank, .suit = card.suit, .is_face_down = card.is_face_down};
+        }
+    }
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        packed->foundation_sizes[i] = (uint8_t)(board->foundations[i].top + 1);
+    }
+    return true;
+}
+
+/**
+ * Unpacks a compact board into a regular game board.
+ * The board's hand is cleared and the foundations are rebuilt from their sizes.
+ */
+void unpack_board(const PackedBoard *packed, Board *board)
+{
+    // Cards left out of the packed board must not keep locations from the board's previous contents
+    memset(board->locations, LOCATION_NONE, sizeof(board->locations));
+    int index = 0;
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        Tableau *tableau = &board->tableaus[i];
+        tableau->top = (int8_t)(packed->tableau_sizes[i] - 1);
+        for (int j = 0; j <= tableau->top; j++)
+        {
+            tableau->cards[j] = packed->cards[index++];
+            set_card_location(board, tableau->cards[j], i, j);
+        }
+    }
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        Foundation *foundation = &board->foundations[i];
+        foundation->suit = (Suit)i;
+        foundation->top = (int8_t)(packed->foundation_sizes[i] - 1);
+        // Foundations always hold Ace up to the top card of their suit
+        for (int j = 0; j <= foundation->top; j++)
+        {
+            foundation->cards[j] = (Card){.rank = j + 1, .suit = (Suit)i, .is_face_down = false};
+            set_card_location(board, foundation->cards[j], LOCATION_FOUNDATION_BASE + i, j);
+        }
+    }
+    board->hand.size = 0;
+    board->hand.origin_tableau = -1;
+    board->hand.origin_position = -1;
+    board->hand.origin_flipped = false;
+    board->hash = compute_board_hash(board);
+}
+
+/**
+ * Checks if two packed boards represent the same position.
+ */
+bool packed_boards_equal(const PackedBoard *packed1, const PackedBoard *packed2)
+{
+    return memcmp(packed1, packed2, sizeof(PackedBoard)) == 0;
+}
+
+/**
+ * Returns a 64-bit FNV-1a hash of a packed board.
+ */
+uint64_t hash_packed_board(const PackedBoard *packed)
+{
+    const uint8_t *bytes = (const uint8_t *)packed;
+    uint64_t hash = 14695981039346656037ULL; // FNV offset basis
+    for (size_t i = 0; i < sizeof(PackedBoard); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL; // FNV prime
+    }
+    return hash;
+}
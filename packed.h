@@ -0,0 +1,33 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+#include "board.h"
+#include "constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file packed.h
+ * Defines a compact, fixed-size representation of the game board
+ * used for storing and comparing large numbers of positions.
+ */
+
+/**
+ * Represents a board in 64 bytes (one cache line).
+ * Only the tableau cards are stored; the foundations are fully described
+ * by their sizes since each foundation holds Ace up to its top card in order.
+ */
+typedef struct
+{
+    Card cards[DECK_SIZE];               // Tableau cards, tableau by tableau from bottom to top
+    uint8_t tableau_sizes[NUM_TABLEAUS]; // Number of cards in each tableau
+    uint8_t foundation_sizes[NUM_SUITS]; // Number of cards in each foundation
+    uint8_t reserved;                    // Padding, always 0
+} PackedBoard;
+
+bool pack_board(const Board *board, PackedBoard *packed);
+void unpack_board(const PackedBoard *packed, Board *board);
+bool packed_boards_equal(const PackedBoard *packed1, const PackedBoard *packed2);
+uint64_t hash_packed_board(const PackedBoard *packed);
+
+#endif // PACKED_H
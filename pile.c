@@ -1,12 +1,16 @@
 #include "cards.h"
 #include "board.h"
+#include "pile.h"
 #include "rules.h"
 #include "constants.h"
+#include "counters.h"
+#include "zobrist.h"
 #include <stddef.h>
 
 /**
  * @file pile.c
- * Implements the functions for managing foundation and tableau piles
+ * Implements the functions for managing foundation and tableau piles.
+ * Every call is counted in the calling thread's counters (see counters.h).
  */
 
 /**
@@ -21,15 +25,17 @@ Card *get_top_pile_card(Card *cards, int top)
 }
 
 /**
- * "Picks up" num_cards cards from a tableau and moves them to the hand.
- * The cards must be face-up.
+ * Helper function with the logic of pick_up_cards, without counting.
  */
-void pick_up_cards(Board *board, int tableau_index, int num_cards)
+static MoveStatus pick_up_cards_uncounted(Board *board, int tableau_index, int num_cards)
 {
     // Check if the tableau index is valid
     if (tableau_index < 0 || tableau_index >= NUM_TABLEAUS)
         // If the tableau index is invalid, return
-        return;
+        return MOVE_INVALID_TABLEAU;
+
+    // Put back any cards still in hand from an unfinished move, so they are not lost
+    return_cards_to_tableau(board);
 
     // Get the pointer to the chosen tableau
     Tableau *tableau = &board->tableaus[tableau_index];
@@ -37,7 +43,7 @@ void pick_up_cards(Board *board, int tableau_index, int num_cards)
     // Check if there are enough cards to pick up
     if (num_cards <= 0 || num_cards > tableau->top + 1)
         // If there are not enough cards to pick up, return
-        return;
+        return MOVE_INVALID_COUNT;
 
     // Check if any of the cards to be picked up are face-down
 
@@ -50,12 +56,17 @@ void pick_up_cards(Board *board, int tableau_index, int num_cards)
         // If any card in the range is face-down
         if (tableau->cards[i].is_face_down)
         {
-            return; // Return without picking up cards
+            return MOVE_FACE_DOWN_CARD; // Return without picking up cards
         }
     }
 
     // Move cards to hand struct
 
+    // Update the hash: the bottom picked-up card now rests on the bottom of the hand
+    Card bottom_card = tableau->cards[start];
+    board->hash ^= get_zobrist_key(bottom_card, get_zobrist_location(tableau->cards, start, ZOBRIST_TABLEAU_BOTTOM)) ^
+                   get_zobrist_key(bottom_card, ZOBRIST_HAND_BASE);
+
     // Set the hand's size to the number of cards being picked up
     board->hand.size = num_cards;
     // Set the hand's origin tableau index and position for potential return
@@ -67,16 +78,34 @@ void pick_up_cards(Board *board, int tableau_index, int num_cards)
     for (int i = 0; i < num_cards; i++)
     {
         // Copy each card from the tableau to the hand
-        board->hand.cards[i] = tableau->cards[start + i];
+        Card card = tableau->cards[start + i];
+        board->hand.cards[i] = card;
+        set_card_location(board, card, LOCATION_HAND, i);
     }
     // Remove cards from tableau by adjusting the top index
     tableau->top -= num_cards;
     // If the move leaves a face-down card on top of the tableau
-    if (tableau->top >= 0 && tableau->cards[tableau->top].is_face_down)
+    board->hand.origin_flipped = tableau->top >= 0 && tableau->cards[tableau->top].is_face_down;
+    if (board->hand.origin_flipped)
     {
-        // Turn the face-down card face-up
+        // Turn the face-down card face-up (turned back if the cards are returned)
         tableau->cards[tableau->top].is_face_down = false;
+        board->hash ^= get_zobrist_key(tableau->cards[tableau->top], ZOBRIST_FACE_DOWN);
     }
+    return MOVE_OK;
+}
+
+/**
+ * "Picks up" num_cards cards from a tableau and moves them to the hand.
+ * The cards must be face-up.
+ * Returns MOVE_OK, or the reason the cards could not be picked up.
+ */
+MoveStatus pick_up_cards(Board *board, int tableau_index, int num_cards)
+{
+    uint64_t start = start_operation();
+    MoveStatus status = pick_up_cards_uncounted(board, tableau_index, num_cards);
+    finish_operation(OPERATION_PICK_UP, status, start);
+    return status;
 }
 
 /**
@@ -85,43 +114,69 @@ void pick_up_cards(Board *board, int tableau_index, int num_cards)
  */
 void return_cards_to_tableau(Board *board)
 {
+    uint64_t start = start_operation();
     // Check if there are cards in hand to return
     if (board->hand.size == 0)
+    {
+        finish_operation(OPERATION_RETURN_CARDS, MOVE_OK, start);
         return; // No cards in hand, return
+    }
     // Get the original tableau index and position from the hand struct
     int tableau_index = board->hand.origin_tableau;
     int position = board->hand.origin_position;
     // Check if the tableau index is valid
     if (tableau_index < 0 || tableau_index >= NUM_TABLEAUS)
+    {
+        finish_operation(OPERATION_RETURN_CARDS, MOVE_INVALID_TABLEAU, start);
         return;
+    }
     // Get the pointer to the original tableau
     Tableau *tableau = &board->tableaus[tableau_index];
+    // Update the hash: the bottom card in hand rests on the tableau again
+    board->hash ^= get_zobrist_key(board->hand.cards[0], ZOBRIST_HAND_BASE) ^
+                   get_zobrist_key(board->hand.cards[0], get_zobrist_location(tableau->cards, position, ZOBRIST_TABLEAU_BOTTOM));
     // Loop through the cards in hand
-    for (int i = 0; i < board->hand.size; i++)
+    int size = board->hand.size;
+    for (int i = 0; i < size; i++)
     {
         // Place each card back onto the tableau at the correct position
-        tableau->cards[position + i] = board->hand.cards[i];
+        Card card = board->hand.cards[i];
+        tableau->cards[position + i] = card;
+        set_card_location(board, card, tableau_index, position + i);
     }
     // Adjust the tableau's top index based on the returned cards
-    tableau->top += board->hand.size;
+    tableau->top += size;
     board->hand.size = 0; // Clear hand after returning cards
+    // A rejected move must not reveal a card, so turn the card picking up uncovered face-down again
+    if (board->hand.origin_flipped)
+    {
+        tableau->cards[position - 1].is_face_down = true;
+        board->hash ^= get_zobrist_key(tableau->cards[position - 1], ZOBRIST_FACE_DOWN);
+        board->hand.origin_flipped = false;
+    }
+    thread_counters.cards_returned += (uint64_t)size;
+    finish_operation(OPERATION_RETURN_CARDS, MOVE_OK, start);
 }
 
 /**
- * Handles the logic for placing cards from the hand onto a tableau.
+ * Helper function with the logic of place_cards_on_tableau, without counting.
  */
-void place_cards_on_tableau(Board *board, int tableau_index)
+static MoveStatus place_cards_on_tableau_uncounted(Board *board, int tableau_index)
 {
     // Check if the tableau index is valid
     if (tableau_index < 0 || tableau_index >= NUM_TABLEAUS)
-        return;
+    {
+        // Put the cards back so they are not left in the hand
+        return_cards_to_tableau(board);
+        return MOVE_INVALID_TABLEAU;
+    }
 
     // Get the pointer to the tableau
     Tableau *tableau = &board->tableaus[tableau_index];
 
     // Check if there are cards in hand to place
     if (board->hand.size == 0)
-        return; // No cards in hand, return
+        return MOVE_EMPTY_HAND; // No cards in hand, return
 
     Card top_card; // Variable to hold the top card of the tableau
     // If the tableau is not empty
@@ -141,7 +196,7 @@ void place_cards_on_tableau(Board *board, int tableau_index)
     if (tableau->top >= 0 && tableau->cards[tableau->top].is_face_down)
     {
         return_cards_to_tableau(board);
-        return;
+        return MOVE_ONTO_FACE_DOWN;
     }
 
     // Yukon rule: only require the first card in hand and the tableau's top card to be in sequence and alternate color
@@ -153,7 +208,7 @@ void place_cards_on_tableau(Board *board, int tableau_index)
         if (board->hand.cards[0].rank != 13)
         {
             return_cards_to_tableau(board);
-            return;
+            return MOVE_NOT_KING;
         }
     }
     else // If tableau is not empty
@@ -163,38 +218,71 @@ void place_cards_on_tableau(Board *board, int tableau_index)
         {
             // If the move is invalid return cards to original tableau
             return_cards_to_tableau(board);
-            return;
+            return MOVE_RULE_VIOLATION;
         }
     }
 
-    // Place cards on tableau
-    for (int i = 0; i < board->hand.size; i++)
+    // Update the hash: the bottom card in hand now rests on the tableau's top card (or its bottom)
+    board->hash ^= get_zobrist_key(board->hand.cards[0], ZOBRIST_HAND_BASE) ^
+                   get_zobrist_key(board->hand.cards[0], get_zobrist_location(tableau->cards, tableau->top + 1, ZOBRIST_TABLEAU_BOTTOM));
+    // Place cards on tableau (with the sizes in locals, as the location updates could alias them)
+    int size = board->hand.size, top = tableau->top;
+    for (int i = 0; i < size; i++)
     {
         // Place each card from the hand onto the tableau
-        tableau->cards[++tableau->top] = board->hand.cards[i];
+        Card card = board->hand.cards[i];
+        tableau->cards[++top] = card;
+        set_card_location(board, card, tableau_index, top);
     }
+    tableau->top = (int8_t)top;
     board->hand.size = 0; // Clear hand after placing cards
+    // The card uncovered when the cards were picked up stays face-up now
+    thread_counters.flips += board->hand.origin_flipped;
 
     // Automatic turning of face-down card after moving all face-up cards
     if (tableau->top >= 0 && tableau->cards[tableau->top].is_face_down)
     {
         tableau->cards[tableau->top].is_face_down = false;
+        board->hash ^= get_zobrist_key(tableau->cards[tableau->top], ZOBRIST_FACE_DOWN);
+        thread_counters.flips++;
     }
+    return MOVE_OK;
 }
 
 /**
- * Handles the logic for placing a card from the hand onto a foundation.
+ * Handles the logic for placing cards from the hand onto a tableau.
+ * Returns MOVE_OK, or the reason the move was rejected (the cards are then returned).
  */
-void place_card_on_foundation(Board *board, int foundation_index)
+MoveStatus place_cards_on_tableau(Board *board, int tableau_index)
+{
+    uint64_t start = start_operation();
+    MoveStatus status = place_cards_on_tableau_uncounted(board, tableau_index);
+    finish_operation(OPERATION_PLACE_ON_TABLEAU, status, start);
+    return status;
+}
+
+/**
+ * Helper function with the logic of place_card_on_foundation, without counting.
+ */
+static MoveStatus place_card_on_foundation_uncounted(Board *board, int foundation_index)
 {
     // Check for valid foundation index
     if (foundation_index < 0 || foundation_index >= NUM_SUITS)
-        return;
+    {
+        // Put the cards back so they are not left in the hand
+        return_cards_to_tableau(board);
+        return MOVE_INVALID_FOUNDATION;
+    }
     // Get the pointer to the foundation
     Foundation *foundation = &board->foundations[foundation_index];
     // Only allow one card to be moved
     if (board->hand.size != 1)
-        return;
+    {
+        MoveStatus status = (board->hand.size == 0) ? MOVE_EMPTY_HAND : MOVE_TOO_MANY_CARDS;
+        // Put the cards back so they are not left in the hand
+        return_cards_to_tableau(board);
+        return status;
+    }
     // Get the top card of the foundation for validation
     Card top_card;
     // If the foundation is not empty get the top card
@@ -212,10 +300,42 @@ void place_card_on_foundation(Board *board, int foundation_index)
     {
         // If the move is invalid return card to original tableau
         return_cards_to_tableau(board);
-        return;
+        return MOVE_RULE_VIOLATION;
     }
+    // Update the hash: the card now rests on the foundation's top card (or its bottom)
+    board->hash ^= get_zobrist_key(board->hand.cards[0], ZOBRIST_HAND_BASE) ^
+                   get_zobrist_key(board->hand.cards[0], get_zobrist_location(foundation->cards, foundation->top + 1, ZOBRIST_FOUNDATION_BASE + foundation_index));
     // Place card on foundation
     foundation->cards[++foundation->top] = board->hand.cards[0];
+    set_card_location(board, board->hand.cards[0], LOCATION_FOUNDATION_BASE + foundation_index, foundation->top);
     // Clear hand after placing card
     board->hand.size = 0;
-}
\ No newline at end of file
+    // The card uncovered when the card was picked up stays face-up now
+    thread_counters.flips += board->hand.origin_flipped;
+    return MOVE_OK;
+}
+
+/**
+ * Handles the logic for placing a card from the hand onto a foundation.
+ * Returns MOVE_OK, or the reason the move was rejected (the cards are then returned).
+ */
+MoveStatus place_card_on_foundation(Board *board, int foundation_index)
+{
+    uint64_t start = start_operation();
+    MoveStatus status = place_card_on_foundation_uncounted(board, foundation_index);
+    finish_operation(OPERATION_PLACE_ON_FOUNDATION, status, start);
+    return status;
+}
+
+/**
+ * Returns a short lowercase name for a MoveStatus, for logs and reports.
+ */
+const char *get_move_status_name(MoveStatus status)
+{
+    static const char *names[NUM_MOVE_STATUSES] = {"ok", "invalid_tableau", "invalid_foundation", "invalid_count",
+                                                   "face_down_card", "empty_hand", "too_many_cards", "onto_face_down",
+                                                   "not_king", "rule_violation", "same_tableau"};
+    if ((int)status < 0 || (int)status >= NUM_MOVE_STATUSES)
+        return "unknown";
+    return names[status];
+}
@@ -1,6 +1,7 @@
 #ifndef PILE_H
 #define PILE_H
 
+#include "board.h"
 #include "cards.h"
 #include <stdbool.h>
 
@@ -9,9 +10,33 @@
  * Defines the functions for managing foundation and tableau piles
  */
 
-void pick_up_cards(Board *board, int tableau_index, int num_cards);
-void place_cards_on_tableau(Board *board, int tableau_index);
-void place_card_on_foundation(Board *board, int foundation_index);
-void pick_up_cards(Board *board, int tableau_index, int num_cards);
+/**
+ * Enum representing the outcome of a pile operation.
+ * Anything other than MOVE_OK means the move was rejected and the board is unchanged
+ * (apart from cards in hand being returned to their tableau).
+ */
+typedef enum
+{
+    MOVE_OK,                 // The operation succeeded
+    MOVE_INVALID_TABLEAU,    // The tableau index is out of range
+    MOVE_INVALID_FOUNDATION, // The foundation index is out of range
+    MOVE_INVALID_COUNT,      // The tableau does not have that many cards
+    MOVE_FACE_DOWN_CARD,     // A card to be picked up is face-down
+    MOVE_EMPTY_HAND,         // There are no cards in hand to place
+    MOVE_TOO_MANY_CARDS,     // More than one card was moved to a foundation
+    MOVE_ONTO_FACE_DOWN,     // The destination tableau's top card is face-down
+    MOVE_NOT_KING,           // Only a King can be placed on an empty tableau
+    MOVE_RULE_VIOLATION,     // The card does not fit on the destination (see rules.c)
+    MOVE_SAME_TABLEAU        // The source and destination are the same tableau (never returned by pile.c,
+                             // used by callers that check whole moves)
+} MoveStatus;
+
+#define NUM_MOVE_STATUSES (MOVE_SAME_TABLEAU + 1) // Number of MoveStatus values, for per-status tables
+
+MoveStatus pick_up_cards(Board *board, int tableau_index, int num_cards);
+MoveStatus place_cards_on_tableau(Board *board, int tableau_index);
+MoveStatus place_card_on_foundation(Board *board, int foundation_index);
+void return_cards_to_tableau(Board *board);
+const char *get_move_status_name(MoveStatus status);
 
 #endif // PILE_H
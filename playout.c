@@ -0,0 +1,139 @@
+#include "playout.h"
+#include "autoplay.h"
+#include "board.h"
+#include "moves.h"
+#include "rng.h"
+#include "win.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file playout.c
+ * Implements the Monte Carlo playout engine.
+ * Each game is played on a copy of the board on the stack,
+ * so playouts never allocate memory.
+ */
+
+/**
+ * Helper function to check if a move puts back the cards the previous move just moved.
+ */
+static bool is_reverse_move(Move move, Move previous)
+{
+    return move.type == MOVE_TO_TABLEAU && previous.type == MOVE_TO_TABLEAU &&
+           move.from == previous.to && move.to == previous.from && move.count == previous.count;
+}
+
+/**
+ * Helper function to pick the next move according to the policy.
+ * Returns false if there is no useful move left.
+ */
+static bool pick_move(const Board *board, PlayoutPolicy policy, Rng *rng, const Move *previous, Move *chosen)
+{
+    Move moves[MAX_MOVES];
+    int num_generated = generate_moves(board, moves);
+
+    // Drop moves that can never help and moves that undo the previous move
+    int num_moves = 0;
+    int best_score = -1, num_best = 0;
+    for (int i = 0; i < num_generated; i++)
+    {
+        int score = score_move(board, moves[i]);
+        if (score < 0 || (previous != NULL && is_reverse_move(moves[i], *previous)))
+            continue;
+        if (policy == POLICY_RANDOM)
+        {
+            moves[num_moves++] = moves[i];
+            continue;
+        }
+        if (policy == POLICY_GREEDY)
+        {
+            // Take the first foundation move straight away
+            if (moves[i].type == MOVE_TO_FOUNDATION)
+            {
+                *chosen = moves[i];
+                return true;
+            }
+            moves[num_moves++] = moves[i];
+            continue;
+        }
+        // Heuristic: keep only the moves with the best score
+        if (score > best_score)
+        {
+            best_score = score;
+            num_best = 0;
+        }
+        if (score == best_score)
+            moves[num_best++] = moves[i];
+    }
+    if (policy == POLICY_HEURISTIC)
+        num_moves = num_best;
+    if (num_moves == 0)
+        return false;
+    *chosen = moves[rng_below(rng, (uint32_t)num_moves)];
+    return true;
+}
+
+/**
+ * Plays one game from the board to the end without changing the board.
+ * Safe cards are sent to the foundations automatically after every move.
+ * Returns true if the game was won. The number of moves chosen by the policy
+ * (not counting auto-played cards) is stored in num_moves.
+ */
+bool play_out(const Board *board, PlayoutPolicy policy, Rng *rng, int *num_moves)
+{
+    Board game = *board;
+    Move move, previous;
+    UndoEntry undo;
+    int moves_played = 0, moves_since_progress = 0;
+    autoplay_safe_cards(&game, NULL);
+    bool won = check_win_condition(&game);
+    while (!won && moves_played < PLAYOUT_MAX_MOVES && moves_since_progress < PLAYOUT_STALL_MOVES &&
+           pick_move(&game, policy, rng, moves_played > 0 ? &previous : NULL, &move))
+    {
+        apply_move(&game, move, &undo);
+        previous = move;
+        moves_played++;
+        // Safe cards go up for free; they are not counted as moves played
+        int num_autoplayed = autoplay_safe_cards(&game, NULL);
+        // Random games easily shuffle cards back and forth forever, so stop when nothing improves
+        if (move.type == MOVE_TO_FOUNDATION || undo.flipped || num_autoplayed > 0)
+            moves_since_progress = 0;
+        else
+            moves_since_progress++;
+        won = check_win_condition(&game);
+    }
+    *num_moves = moves_played;
+    return won;
+}
+
+/**
+ * Plays num_games games from the board and adds the results to stats.
+ * stats must be zeroed before the first call.
+ */
+void run_playouts(const Board *board, PlayoutPolicy policy, int num_games, Rng *rng, PlayoutStats *stats)
+{
+    for (int i = 0; i < num_games; i++)
+    {
+        int num_moves;
+        bool won = play_out(board, policy, rng, &num_moves);
+        stats->games++;
+        stats->total_moves += (uint64_t)num_moves;
+        if (won)
+        {
+            if (stats->wins == 0 || num_moves < stats->min_win_moves)
+                stats->min_win_moves = num_moves;
+            if (num_moves > stats->max_win_moves)
+                stats->max_win_moves = num_moves;
+            stats->wins++;
+            stats->total_win_moves += (uint64_t)num_moves;
+        }
+    }
+}
+
+/**
+ * Returns the fraction of playouts that were won (0 if none were played).
+ */
+double get_win_rate(const PlayoutStats *stats)
+{
+    return stats->games == 0 ? 0.0 : (double)stats->wins / (double)stats->games;
+}
@@ -0,0 +1,54 @@
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include "board.h"
+#include "moves.h"
+#include "rng.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file playout.h
+ * Defines the Monte Carlo playout engine, which plays games to the end
+ * from a position to estimate how likely it is to be won.
+ */
+
+/**
+ * Maximum number of moves in one playout. Games that reach it count as lost.
+ */
+#define PLAYOUT_MAX_MOVES 1000
+
+/**
+ * Number of moves in a row without progress (a foundation move or a card turned over)
+ * after which a playout gives up and counts as lost.
+ */
+#define PLAYOUT_STALL_MOVES 50
+
+/**
+ * Enum representing how a playout picks its moves.
+ */
+typedef enum
+{
+    POLICY_RANDOM,    // A useful move chosen uniformly at random (legal, score_move >= 0 and not undoing the last move)
+    POLICY_GREEDY,    // A foundation move if there is one, otherwise a random useful move
+    POLICY_HEURISTIC  // The move with the best score_move, ties broken at random
+} PlayoutPolicy;
+
+/**
+ * Represents the statistics of a set of playouts.
+ */
+typedef struct
+{
+    uint64_t games;           // Number of games played
+    uint64_t wins;            // Number of games won
+    uint64_t total_moves;     // Moves played over all games
+    uint64_t total_win_moves; // Moves played over won games
+    int min_win_moves;        // Fewest moves in a won game (0 if no game was won)
+    int max_win_moves;        // Most moves in a won game
+} PlayoutStats;
+
+bool play_out(const Board *board, PlayoutPolicy policy, Rng *rng, int *num_moves);
+void run_playouts(const Board *board, PlayoutPolicy policy, int num_games, Rng *rng, PlayoutStats *stats);
+double get_win_rate(const PlayoutStats *stats);
+
+#endif // PLAYOUT_H
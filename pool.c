@@ -0,0 +1,100 @@
+#include "pool.h"
+#include "board.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/**
+ * @file pool.c
+ * Implements the board pool as a list of slabs and a free list.
+ * Running out of memory is reported to the caller instead of exiting.
+ */
+
+/**
+ * Helper function to allocate one more slab and put its slots on the free list.
+ * Returns false if the pool is at its limit or the allocation fails.
+ */
+static bool grow_board_pool(BoardPool *pool)
+{
+    if (pool->max_boards != 0 && pool->capacity >= pool->max_boards)
+        return false;
+    BoardPoolSlab *slab = malloc(sizeof(BoardPoolSlab));
+    if (slab == NULL)
+        return false;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    // Push the slots in reverse so they are handed out in memory order
+    for (int i = BOARD_POOL_SLAB_SIZE - 1; i >= 0; i--)
+    {
+        slab->slots[i].next_free = pool->free_list;
+        pool->free_list = &slab->slots[i];
+    }
+    pool->capacity += BOARD_POOL_SLAB_SIZE;
+    return true;
+}
+
+/**
+ * Initializes a pool with room for at least initial_boards boards.
+ * max_boards limits how many boards the pool may ever hold (0 for no limit);
+ * it is rounded up to a whole number of slabs.
+ * Returns false if the initial slabs cannot be allocated.
+ */
+bool init_board_pool(BoardPool *pool, size_t initial_boards, size_t max_boards)
+{
+    pool->free_list = NULL;
+    pool->slabs = NULL;
+    pool->capacity = 0;
+    pool->max_boards = max_boards;
+    pool->in_use = 0;
+    while (pool->capacity < initial_boards)
+    {
+        if (!grow_board_pool(pool))
+        {
+            destroy_board_pool(pool);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns an empty board from the pool, or NULL if the pool is full
+ * or memory cannot be allocated.
+ */
+Board *board_pool_acquire(BoardPool *pool)
+{
+    if (pool->free_list == NULL && !grow_board_pool(pool))
+        return NULL;
+    BoardPoolSlot *slot = pool->free_list;
+    pool->free_list = slot->next_free;
+    pool->in_use++;
+    reset_board(&slot->board);
+    return &slot->board;
+}
+
+/**
+ * Gives a board back to the pool. The board must have come from this pool.
+ */
+void board_pool_release(BoardPool *pool, Board *board)
+{
+    BoardPoolSlot *slot = (BoardPoolSlot *)board;
+    slot->next_free = pool->free_list;
+    pool->free_list = slot;
+    pool->in_use--;
+}
+
+/**
+ * Frees every slab of the pool. Boards acquired from it become invalid.
+ */
+void destroy_board_pool(BoardPool *pool)
+{
+    while (pool->slabs != NULL)
+    {
+        BoardPoolSlab *next = pool->slabs->next;
+        free(pool->slabs);
+        pool->slabs = next;
+    }
+    pool->free_list = NULL;
+    pool->capacity = 0;
+    pool->in_use = 0;
+}
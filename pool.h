@@ -0,0 +1,55 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "board.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file pool.h
+ * Defines a pool of reusable boards for hosting many games at once.
+ */
+
+/**
+ * Number of boards allocated together in one slab.
+ */
+#define BOARD_POOL_SLAB_SIZE 256
+
+/**
+ * Represents a board slot in a pool. A free slot stores the next free slot instead of a board.
+ */
+typedef union BoardPoolSlot
+{
+    Board board;
+    union BoardPoolSlot *next_free;
+} BoardPoolSlot;
+
+/**
+ * Represents a slab of board slots allocated with one malloc.
+ */
+typedef struct BoardPoolSlab
+{
+    struct BoardPoolSlab *next; // Next slab in the pool
+    BoardPoolSlot slots[BOARD_POOL_SLAB_SIZE];
+} BoardPoolSlab;
+
+/**
+ * Represents a pool of boards. Released boards go on a free list and are
+ * handed out again by the next acquire, so a busy pool does no allocation.
+ * A pool is not thread-safe; use one pool per thread.
+ */
+typedef struct
+{
+    BoardPoolSlot *free_list; // Free slots, most recently released first
+    BoardPoolSlab *slabs;     // All slabs owned by the pool
+    size_t capacity;          // Number of slots in all slabs
+    size_t max_boards;        // Maximum number of slots (0 for no limit)
+    size_t in_use;            // Number of boards currently acquired
+} BoardPool;
+
+bool init_board_pool(BoardPool *pool, size_t initial_boards, size_t max_boards);
+Board *board_pool_acquire(BoardPool *pool);
+void board_pool_release(BoardPool *pool, Board *board);
+void destroy_board_pool(BoardPool *pool);
+
+#endif // POOL_H
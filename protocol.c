@@ -0,0 +1,335 @@
+#include "protocol.h"
+#include "autoplay.h"
+#include "bitboard.h"
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include "hint.h"
+#include "moves.h"
+#include "pile.h"
+#include "record.h"
+#include "win.h"
+#include "zobrist.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file protocol.c
+ * Implements the engine protocol: parsing and formatting of moves and positions,
+ * and the handling of one command line.
+ */
+
+static const char RANK_CHARS[] = "A23456789TJQK";
+static const char SUIT_CHARS[] = "hdcs";
+
+/**
+ * Starts a session playing on the given board, which is emptied.
+ * The first command is normally "new" or "set".
+ */
+void init_engine(Engine *engine, Board *board)
+{
+    engine->board = board;
+    reset_board(board);
+    init_undo_stack(&engine->undo_stack);
+    engine->autoplay = false;
+    engine->max_hint_budget_us = UINT64_MAX;
+}
+
+/**
+ * Parses a move such as "2-5:3", "2-5" or "4-f1".
+ * Only the syntax and ranges are checked, not whether the move is legal.
+ */
+bool parse_move(const char *text, Move *move)
+{
+    char *end;
+    long from = strtol(text, &end, 10);
+    if (end == text || *end != '-' || from < 1 || from > NUM_TABLEAUS)
+        return false;
+    text = end + 1;
+    bool to_foundation = (*text == 'f');
+    if (to_foundation)
+        text++;
+    long to = strtol(text, &end, 10);
+    if (end == text || to < 1 || to > (to_foundation ? NUM_SUITS : NUM_TABLEAUS))
+        return false;
+    long count = 1;
+    if (*end == ':' && !to_foundation)
+    {
+        text = end + 1;
+        count = strtol(text, &end, 10);
+        if (end == text || count < 1 || count > TABLEAU_MAX_SIZE)
+            return false;
+    }
+    if (*end != '\0')
+        return false;
+    move->type = to_foundation ? MOVE_TO_FOUNDATION : MOVE_TO_TABLEAU;
+    move->from = (uint8_t)(from - 1);
+    move->to = (uint8_t)(to - 1);
+    move->count = (uint8_t)count;
+    return true;
+}
+
+/**
+ * Writes a move in protocol form (at most MAX_MOVE_TEXT characters with the terminator).
+ */
+void format_move(Move move, char *text)
+{
+    if (move.type == MOVE_TO_FOUNDATION)
+        snprintf(text, MAX_MOVE_TEXT, "%d-f%d", move.from + 1, move.to + 1);
+    else if (move.count == 1)
+        snprintf(text, MAX_MOVE_TEXT, "%d-%d", move.from + 1, move.to + 1);
+    else
+        snprintf(text, MAX_MOVE_TEXT, "%d-%d:%d", move.from + 1, move.to + 1, move.count);
+}
+
+/**
+ * Parses a position (see protocol.h) into a board, with its hash and card locations.
+ * Returns false, leaving the board alone, unless the position holds every card exactly once,
+ * with the face-down cards of each tableau below its face-up cards.
+ */
+bool parse_position(const char *text, Board *board)
+{
+    static Board parsed;
+    reset_board(&parsed);
+    CardMask seen = 0;
+
+    // Foundation sizes
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        char *end;
+        long size = strtol(text, &end, 10);
+        if (end == text || size < 0 || size > FOUNDATION_SIZE || *end != (f + 1 < NUM_SUITS ? ',' : ' '))
+            return false;
+        text = end + 1;
+        parsed.foundations[f].top = (int8_t)(size - 1);
+        for (int i = 0; i < size; i++)
+        {
+            Card card = {.rank = (uint8_t)(i + 1), .suit = (uint8_t)f};
+            parsed.foundations[f].cards[i] = card;
+            seen |= get_card_mask(card);
+        }
+    }
+
+    // Tableaus, bottom to top
+    int t = 0;
+    while (*text != '\0' && *text != '\n' && *text != '\r')
+    {
+        if (*text == '/')
+        {
+            if (++t >= NUM_TABLEAUS)
+                return false;
+            text++;
+            continue;
+        }
+        bool face_down = (*text == '#');
+        if (face_down)
+            text++;
+        const char *rank = *text != '\0' ? strchr(RANK_CHARS, *text) : NULL;
+        const char *suit = (rank != NULL && text[1] != '\0') ? strchr(SUIT_CHARS, text[1]) : NULL;
+        if (suit == NULL)
+            return false;
+        text += 2;
+        Card card = {.rank = (uint8_t)(rank - RANK_CHARS + 1), .suit = (uint8_t)(suit - SUIT_CHARS),
+                     .is_face_down = face_down};
+        Tableau *tableau = &parsed.tableaus[t];
+        // Each card once, and no face-down card on top of a face-up card
+        if ((seen & get_card_mask(card)) != 0 ||
+            (face_down && tableau->top >= 0 && !tableau->cards[tableau->top].is_face_down))
+            return false;
+        seen |= get_card_mask(card);
+        tableau->cards[++tableau->top] = card;
+    }
+    if (t != NUM_TABLEAUS - 1 || seen != (1ULL << DECK_SIZE) - 1)
+        return false;
+    // A face-down card is never left on top
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        if (parsed.tableaus[i].top >= 0 && parsed.tableaus[i].cards[parsed.tableaus[i].top].is_face_down)
+            return false;
+    }
+    rebuild_card_locations(&parsed);
+    parsed.hash = compute_board_hash(&parsed);
+    *board = parsed;
+    return true;
+}
+
+/**
+ * Writes a position in protocol form (at most MAX_POSITION_TEXT characters with the terminator).
+ */
+void format_position(const Board *board, char *text)
+{
+    text += sprintf(text, "%d,%d,%d,%d ", board->foundations[0].top + 1, board->foundations[1].top + 1,
+                    board->foundations[2].top + 1, board->foundations[3].top + 1);
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        if (t > 0)
+            *text++ = '/';
+        for (int i = 0; i <= board->tableaus[t].top; i++)
+        {
+            Card card = board->tableaus[t].cards[i];
+            if (card.is_face_down)
+                *text++ = '#';
+            *text++ = RANK_CHARS[card.rank - 1];
+            *text++ = SUIT_CHARS[card.suit];
+        }
+    }
+    *text = '\0';
+}
+
+/**
+ * Helper function to apply a move for the "apply" command and write its response.
+ */
+static void apply_engine_move(Engine *engine, const char *argument, FILE *output)
+{
+    Move move;
+    if (!parse_move(argument, &move))
+    {
+        fputs("error bad_move\n", output);
+        return;
+    }
+    UndoEntry undo;
+    if (!apply_move(engine->board, move, &undo))
+    {
+        // Ask the reference implementation why, on a copy
+        static Board copy;
+        copy = *engine->board;
+        fprintf(output, "illegal %s\n", get_move_status_name(play_move_through_piles(&copy, move)));
+        return;
+    }
+    push_undo_entry(&engine->undo_stack, &undo);
+    fputs("ok", output);
+    if (engine->autoplay)
+    {
+        UndoEntry autoplayed[MAX_AUTOPLAY_MOVES];
+        int num_autoplayed = autoplay_safe_cards(engine->board, autoplayed);
+        if (num_autoplayed > 0)
+            fputs(" auto", output);
+        for (int i = 0; i < num_autoplayed; i++)
+        {
+            char text[MAX_MOVE_TEXT];
+            format_move(autoplayed[i].move, text);
+            fprintf(output, " %s", text);
+            push_undo_entry(&engine->undo_stack, &autoplayed[i]);
+        }
+    }
+    fputs(check_win_condition(engine->board) ? " won\n" : "\n", output);
+}
+
+/**
+ * Handles one command line and writes its response line.
+ * The line may be changed. Returns false when the session should end.
+ */
+bool handle_engine_command(Engine *engine, char *line, FILE *output)
+{
+    // Split the line into the command and the rest, without surrounding whitespace
+    line[strcspn(line, "\r\n")] = '\0';
+    while (*line == ' ' || *line == '\t')
+        line++;
+    char *argument = line + strcspn(line, " \t");
+    if (*argument != '\0')
+        *argument++ = '\0';
+    while (*argument == ' ' || *argument == '\t')
+        argument++;
+    size_t length = strlen(argument);
+    while (length > 0 && (argument[length - 1] == ' ' || argument[length - 1] == '\t'))
+        argument[--length] = '\0';
+
+    if (*line == '\0')
+        return true; // Blank lines are ignored
+    if (strcmp(line, "quit") == 0)
+        return false;
+    if (strcmp(line, "new") == 0)
+    {
+        char *end;
+        unsigned long long seed = strtoull(argument, &end, 10);
+        if (end == argument || *end != '\0')
+        {
+            fputs("error bad_seed\n", output);
+            return true;
+        }
+        initialize_board_from_seed(engine->board, (uint64_t)seed);
+        init_undo_stack(&engine->undo_stack);
+        fputs("ok\n", output);
+    }
+    else if (strcmp(line, "get") == 0)
+    {
+        char text[MAX_POSITION_TEXT];
+        format_position(engine->board, text);
+        fprintf(output, "position %s\n", text);
+    }
+    else if (strcmp(line, "set") == 0)
+    {
+        if (!parse_position(argument, engine->board))
+        {
+            fputs("error bad_position\n", output);
+            return true;
+        }
+        init_undo_stack(&engine->undo_stack);
+        fputs("ok\n", output);
+    }
+    else if (strcmp(line, "moves") == 0)
+    {
+        Move moves[MAX_MOVES];
+        int num_moves = generate_moves(engine->board, moves);
+        fputs("moves", output);
+        for (int i = 0; i < num_moves; i++)
+        {
+            char text[MAX_MOVE_TEXT];
+            format_move(moves[i], text);
+            fprintf(output, " %s", text);
+        }
+        fputc('\n', output);
+    }
+    else if (strcmp(line, "apply") == 0)
+    {
+        apply_engine_move(engine, argument, output);
+    }
+    else if (strcmp(line, "undo") == 0)
+    {
+        // Takes back the whole of the last apply, with its auto-played cards
+        if (undo_last_move(&engine->undo_stack, engine->board) > 0)
+            fputs("ok\n", output);
+        else
+            fputs("error nothing_to_undo\n", output);
+    }
+    else if (strcmp(line, "hint") == 0)
+    {
+        uint64_t budget_us = ENGINE_HINT_BUDGET_US;
+        if (*argument != '\0')
+        {
+            char *end;
+            budget_us = strtoull(argument, &end, 10);
+            if (*argument < '0' || *argument > '9' || *end != '\0')
+            {
+                fputs("error bad_budget\n", output);
+                return true;
+            }
+        }
+        if (budget_us > engine->max_hint_budget_us)
+            budget_us = engine->max_hint_budget_us;
+        Move move;
+        if (suggest_move(engine->board, budget_us, &move))
+        {
+            char text[MAX_MOVE_TEXT];
+            format_move(move, text);
+            fprintf(output, "hint %s\n", text);
+        }
+        else
+        {
+            fputs("hint none\n", output);
+        }
+    }
+    else if (strcmp(line, "auto") == 0 && (strcmp(argument, "on") == 0 || strcmp(argument, "off") == 0))
+    {
+        engine->autoplay = (strcmp(argument, "on") == 0);
+        fputs("ok\n", output);
+    }
+    else
+    {
+        fputs("error unknown_command\n", output);
+    }
+    return true;
+}
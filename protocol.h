@@ -0,0 +1,58 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "board.h"
+#include "moves.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file protocol.h
+ * Defines the line-based engine protocol spoken by yukon-engine.
+ *
+ * Every command is one line and gets exactly one response line; nothing else is printed.
+ * Tableaus are numbered 1-7 and foundations 1-4 (Hearts, Diamonds, Clubs, Spades).
+ *
+ *   new <seed>          -> ok                        Deals the given seed
+ *   get                 -> position <position>       Prints the position
+ *   set <position>      -> ok | error bad_position   Replaces the position
+ *   moves               -> moves [<move> ...]        Lists the legal moves
+ *   apply <move>        -> ok [auto <move> ...] [won] | illegal <reason> | error bad_move
+ *   undo                -> ok | error nothing_to_undo   Takes back the last apply, with its auto-played cards
+ *   hint [<budget_us>]  -> hint <move> | hint none | error bad_budget
+ *   auto on|off         -> ok                        Sends safe cards up after every move (off by default)
+ *   quit                   Ends the session without a response
+ *
+ * A move is "<from>-<to>:<count>" between tableaus (":<count>" may be left out for 1)
+ * or "<from>-f<foundation>" to a foundation, for example "2-5:3" or "4-f1".
+ * A position is the four foundation sizes separated by commas, a space, then the seven tableaus
+ * from bottom to top separated by '/'. A card is its rank (A23456789TJQK) and suit (hdcs),
+ * with '#' in front if it is face-down, for example "0,0,0,0 Kh/#5c9d/...".
+ * The reason for an illegal move is a MoveStatus name (see get_move_status_name).
+ */
+
+#define ENGINE_HINT_BUDGET_US 5000 // Hint time budget when the command does not give one
+#define MAX_MOVE_TEXT 16           // Longest move in text form, with its terminator
+#define MAX_POSITION_TEXT 256      // Longest position in text form, with its terminator
+
+/**
+ * Holds the state of one engine session.
+ */
+typedef struct
+{
+    Board *board; // Owned by the caller, so a server can keep its boards in a BoardPool
+    UndoStack undo_stack;
+    bool autoplay; // Whether safe cards are sent to the foundations after every move
+    uint64_t max_hint_budget_us; // Longest hint search, whatever budget the command asks for
+} Engine;
+
+void init_engine(Engine *engine, Board *board);
+bool handle_engine_command(Engine *engine, char *line, FILE *output);
+bool parse_move(const char *text, Move *move);
+void format_move(Move move, char *text);
+bool parse_position(const char *text, Board *board);
+void format_position(const Board *board, char *text);
+
+#endif // PROTOCOL_H
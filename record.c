@@ -0,0 +1,303 @@
+#include "record.h"
+#include "board.h"
+#include "moves.h"
+#include "pile.h"
+#include "constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @file record.c
+ * Implements the binary game record writer, reader and replayer.
+ */
+
+#define FNV32_OFFSET_BASIS 2166136261u
+#define FNV32_PRIME 16777619u
+
+/**
+ * Encodes a move into one or two bytes. Returns the number of bytes written.
+ */
+int encode_record_move(Move move, uint8_t *bytes)
+{
+    if (move.type == MOVE_TO_FOUNDATION)
+    {
+        bytes[0] = (uint8_t)(0x80 | (move.to << 3) | move.from);
+        return 1;
+    }
+    if (move.count == 1)
+    {
+        bytes[0] = (uint8_t)(0x40 | (move.from << 3) | move.to);
+        return 1;
+    }
+    bytes[0] = (uint8_t)((move.from << 3) | move.to);
+    bytes[1] = move.count;
+    return 2;
+}
+
+/**
+ * Decodes a move from the start of a buffer of size bytes.
+ * Returns the number of bytes used, or 0 if the bytes are not a valid move
+ * (including the end marker and a move cut off by the end of the buffer).
+ */
+int decode_record_move(const uint8_t *bytes, size_t size, Move *move)
+{
+    if (size == 0)
+        return 0;
+    uint8_t first = bytes[0];
+    if (first & 0x80)
+    {
+        // Foundation move: the two bits above the foundation index must be clear
+        if (first & 0x60)
+            return 0;
+        *move = (Move){MOVE_TO_FOUNDATION, (uint8_t)(first & 0x07), (uint8_t)((first >> 3) & 0x03), 1};
+        return (move->from < NUM_TABLEAUS) ? 1 : 0;
+    }
+    uint8_t from = (first >> 3) & 0x07, to = first & 0x07;
+    if (from >= NUM_TABLEAUS || to >= NUM_TABLEAUS)
+        return 0;
+    if (first & 0x40)
+    {
+        *move = (Move){MOVE_TO_TABLEAU, from, to, 1};
+        return 1;
+    }
+    // Group moves of one card always use the short form
+    if (size < 2 || bytes[1] < 2 || bytes[1] > DECK_SIZE)
+        return 0;
+    *move = (Move){MOVE_TO_TABLEAU, from, to, bytes[1]};
+    return 2;
+}
+
+/**
+ * Adds bytes to a running FNV-1a checksum and returns the new checksum.
+ */
+uint32_t update_record_checksum(uint32_t checksum, const uint8_t *bytes, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        checksum ^= bytes[i];
+        checksum *= FNV32_PRIME;
+    }
+    return checksum;
+}
+
+/**
+ * Helper function to write bytes to the record and add them to the checksum.
+ */
+static bool write_bytes(RecordWriter *writer, const uint8_t *bytes, size_t size)
+{
+    writer->checksum = update_record_checksum(writer->checksum, bytes, size);
+    return fwrite(bytes, 1, size, writer->file) == size;
+}
+
+/**
+ * Starts a record for the deal with the given seed by writing its header.
+ * Returns false if the file cannot be written.
+ */
+bool open_record_writer(RecordWriter *writer, FILE *file, uint64_t seed)
+{
+    writer->file = file;
+    writer->checksum = FNV32_OFFSET_BASIS;
+    uint8_t header[RECORD_HEADER_SIZE] = {'Y', 'K', 'R', RECORD_VERSION};
+    for (int i = 0; i < 8; i++)
+    {
+        header[4 + i] = (uint8_t)(seed >> (8 * i));
+    }
+    return write_bytes(writer, header, sizeof(header));
+}
+
+/**
+ * Appends a move to the record. Returns false if the file cannot be written.
+ */
+bool write_record_move(RecordWriter *writer, Move move)
+{
+    uint8_t bytes[RECORD_MAX_MOVE_SIZE];
+    int size = encode_record_move(move, bytes);
+    return write_bytes(writer, bytes, (size_t)size);
+}
+
+/**
+ * Ends the record by writing the end marker and checksum.
+ * The file itself is left open. Returns false if the file cannot be written.
+ */
+bool close_record_writer(RecordWriter *writer)
+{
+    uint8_t end = RECORD_END_MARKER;
+    if (!write_bytes(writer, &end, 1))
+        return false;
+    uint8_t checksum[RECORD_CHECKSUM_SIZE];
+    for (int i = 0; i < RECORD_CHECKSUM_SIZE; i++)
+    {
+        checksum[i] = (uint8_t)(writer->checksum >> (8 * i));
+    }
+    return fwrite(checksum, 1, sizeof(checksum), writer->file) == sizeof(checksum);
+}
+
+/**
+ * Starts reading a record by reading and checking its header.
+ * Returns false if the header is missing or not a supported record.
+ */
+bool open_record_reader(RecordReader *reader, FILE *file)
+{
+    reader->file = file;
+    reader->checksum = FNV32_OFFSET_BASIS;
+    uint8_t header[RECORD_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header))
+        return false;
+    if (header[0] != 'Y' || header[1] != 'K' || header[2] != 'R' || header[3] != RECORD_VERSION)
+        return false;
+    reader->seed = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        reader->seed |= (uint64_t)header[4 + i] << (8 * i);
+    }
+    reader->checksum = update_record_checksum(reader->checksum, header, sizeof(header));
+    return true;
+}
+
+/**
+ * Reads the next move of a record.
+ * At the end marker the checksum is checked and RECORD_END or RECORD_ERROR is returned.
+ */
+RecordStatus read_record_move(RecordReader *reader, Move *move)
+{
+    uint8_t bytes[RECORD_MAX_MOVE_SIZE];
+    int c = getc(reader->file);
+    if (c == EOF)
+        return RECORD_ERROR;
+    bytes[0] = (uint8_t)c;
+    size_t size = 1;
+
+    if (bytes[0] == RECORD_END_MARKER)
+    {
+        reader->checksum = update_record_checksum(reader->checksum, bytes, 1);
+        uint8_t stored[RECORD_CHECKSUM_SIZE];
+        if (fread(stored, 1, sizeof(stored), reader->file) != sizeof(stored))
+            return RECORD_ERROR;
+        uint32_t checksum = 0;
+        for (int i = 0; i < RECORD_CHECKSUM_SIZE; i++)
+        {
+            checksum |= (uint32_t)stored[i] << (8 * i);
+        }
+        return (checksum == reader->checksum) ? RECORD_END : RECORD_ERROR;
+    }
+
+    // Group moves carry their count in a second byte
+    if ((bytes[0] & 0xC0) == 0)
+    {
+        c = getc(reader->file);
+        if (c == EOF)
+            return RECORD_ERROR;
+        bytes[size++] = (uint8_t)c;
+    }
+    if (decode_record_move(bytes, size, move) != (int)size)
+        return RECORD_ERROR;
+    reader->checksum = update_record_checksum(reader->checksum, bytes, size);
+    return RECORD_MOVE;
+}
+
+/**
+ * Returns the size of the record at the start of a buffer,
+ * or 0 if the buffer does not start with a complete record.
+ * Only the header and framing are checked; the moves and checksum are checked when replaying.
+ */
+size_t get_record_size(const uint8_t *bytes, size_t size)
+{
+    if (size < RECORD_HEADER_SIZE || bytes[0] != 'Y' || bytes[1] != 'K' || bytes[2] != 'R' || bytes[3] != RECORD_VERSION)
+        return 0;
+    // Moves never contain the end marker, so the first one found ends the record
+    const uint8_t *end = memchr(bytes + RECORD_HEADER_SIZE, RECORD_END_MARKER, size - RECORD_HEADER_SIZE);
+    if (end == NULL)
+        return 0;
+    size_t record_size = (size_t)(end - bytes) + 1 + RECORD_CHECKSUM_SIZE;
+    return (record_size <= size) ? record_size : 0;
+}
+
+/**
+ * Plays a move through pick_up_cards and place_cards_on_tableau / place_card_on_foundation.
+ * Returns MOVE_OK, or the reason the move was rejected.
+ */
+MoveStatus play_move_through_piles(Board *board, Move move)
+{
+    // A move back onto the source tableau is never legal (see is_legal_move)
+    if (move.type == MOVE_TO_TABLEAU && move.from == move.to)
+        return MOVE_SAME_TABLEAU;
+    MoveStatus status = pick_up_cards(board, move.from, move.count);
+    if (status != MOVE_OK)
+        return status;
+    if (move.type == MOVE_TO_FOUNDATION)
+        return place_card_on_foundation(board, move.to);
+    return place_cards_on_tableau(board, move.to);
+}
+
+/**
+ * Rebuilds a game from its record: deals the recorded seed onto the board
+ * and plays every move through pile.c, stopping at the first rejected move.
+ */
+ReplayStatus replay_record(FILE *file, Board *board, ReplayResult *result)
+{
+    RecordReader reader;
+    result->num_moves = 0;
+    result->move_status = MOVE_OK;
+    result->seed = 0;
+    if (!open_record_reader(&reader, file))
+        return result->status = REPLAY_BAD_RECORD;
+    result->seed = reader.seed;
+    initialize_board_from_seed(board, reader.seed);
+    Move move;
+    RecordStatus status;
+    while ((status = read_record_move(&reader, &move)) == RECORD_MOVE)
+    {
+        result->move_status = play_move_through_piles(board, move);
+        if (result->move_status != MOVE_OK)
+            return result->status = REPLAY_ILLEGAL_MOVE;
+        result->num_moves++;
+    }
+    return result->status = (status == RECORD_END) ? REPLAY_OK : REPLAY_BAD_RECORD;
+}
+
+/**
+ * Same as replay_record, for a record held in memory (for example one found with get_record_size).
+ * The checksum is checked before any move is played.
+ */
+ReplayStatus replay_record_buffer(const uint8_t *bytes, size_t size, Board *board, ReplayResult *result)
+{
+    result->num_moves = 0;
+    result->move_status = MOVE_OK;
+    result->seed = 0;
+    size_t record_size = get_record_size(bytes, size);
+    if (record_size == 0)
+        return result->status = REPLAY_BAD_RECORD;
+
+    // Check the checksum over everything up to and including the end marker
+    size_t checksum_offset = record_size - RECORD_CHECKSUM_SIZE;
+    uint32_t stored = 0;
+    for (int i = 0; i < RECORD_CHECKSUM_SIZE; i++)
+    {
+        stored |= (uint32_t)bytes[checksum_offset + i] << (8 * i);
+    }
+    if (update_record_checksum(FNV32_OFFSET_BASIS, bytes, checksum_offset) != stored)
+        return result->status = REPLAY_BAD_RECORD;
+
+    for (int i = 0; i < 8; i++)
+    {
+        result->seed |= (uint64_t)bytes[4 + i] << (8 * i);
+    }
+    initialize_board_from_seed(board, result->seed);
+    size_t offset = RECORD_HEADER_SIZE;
+    size_t moves_end = checksum_offset - 1; // Offset of the end marker
+    while (offset < moves_end)
+    {
+        Move move;
+        int move_size = decode_record_move(bytes + offset, moves_end - offset, &move);
+        if (move_size == 0)
+            return result->status = REPLAY_BAD_RECORD;
+        result->move_status = play_move_through_piles(board, move);
+        if (result->move_status != MOVE_OK)
+            return result->status = REPLAY_ILLEGAL_MOVE;
+        result->num_moves++;
+        offset += (size_t)move_size;
+    }
+    return result->status = REPLAY_OK;
+}
@@ -0,0 +1,98 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "board.h"
+#include "moves.h"
+#include "pile.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file record.h
+ * Defines the compact binary game record format and its streaming writer, reader and replayer.
+ *
+ * A record is laid out as:
+ *   header    "YKR" + version byte, then the deal seed (8 bytes, little-endian)
+ *   moves     one or two bytes per move:
+ *               1xxttfff           foundation move from tableau fff to foundation tt (xx = 0)
+ *               01fffttt           tableau move of one card from tableau fff to tableau ttt
+ *               00fffttt count     tableau move of count cards
+ *   end       0xFF (never the first byte of a move, nor a count)
+ *   checksum  FNV-1a 32-bit hash of every byte before it (4 bytes, little-endian)
+ */
+
+#define RECORD_VERSION 1
+#define RECORD_HEADER_SIZE 12
+#define RECORD_END_MARKER 0xFF
+#define RECORD_CHECKSUM_SIZE 4
+#define RECORD_MAX_MOVE_SIZE 2
+
+/**
+ * Enum representing the result of reading from a record.
+ */
+typedef enum
+{
+    RECORD_MOVE,  // A move was read
+    RECORD_END,   // The end of the record was reached and the checksum matched
+    RECORD_ERROR  // The record is truncated, malformed or its checksum does not match
+} RecordStatus;
+
+/**
+ * Enum representing the result of replaying a record.
+ */
+typedef enum
+{
+    REPLAY_OK,           // Every move was applied
+    REPLAY_BAD_RECORD,   // The record could not be read
+    REPLAY_ILLEGAL_MOVE  // A move in the record was rejected
+} ReplayStatus;
+
+/**
+ * Represents the result of replaying a record.
+ */
+typedef struct
+{
+    ReplayStatus status;
+    uint64_t seed;          // Seed of the recorded deal
+    uint32_t num_moves;     // Number of moves applied
+    MoveStatus move_status; // Why the next move was rejected (when status is REPLAY_ILLEGAL_MOVE)
+} ReplayResult;
+
+/**
+ * Represents a record being written to a file.
+ */
+typedef struct
+{
+    FILE *file;
+    uint32_t checksum; // Running checksum of the bytes written so far
+} RecordWriter;
+
+/**
+ * Represents a record being read from a file.
+ */
+typedef struct
+{
+    FILE *file;
+    uint32_t checksum; // Running checksum of the bytes read so far
+    uint64_t seed;     // Seed of the recorded deal
+} RecordReader;
+
+int encode_record_move(Move move, uint8_t *bytes);
+int decode_record_move(const uint8_t *bytes, size_t size, Move *move);
+uint32_t update_record_checksum(uint32_t checksum, const uint8_t *bytes, size_t size);
+
+bool open_record_writer(RecordWriter *writer, FILE *file, uint64_t seed);
+bool write_record_move(RecordWriter *writer, Move move);
+bool close_record_writer(RecordWriter *writer);
+
+bool open_record_reader(RecordReader *reader, FILE *file);
+RecordStatus read_record_move(RecordReader *reader, Move *move);
+
+size_t get_record_size(const uint8_t *bytes, size_t size);
+MoveStatus play_move_through_piles(Board *board, Move move);
+ReplayStatus replay_record(FILE *file, Board *board, ReplayResult *result);
+ReplayStatus replay_record_buffer(const uint8_t *bytes, size_t size, Board *board, ReplayResult *result);
+
+#endif // RECORD_H
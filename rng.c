@@ -0,0 +1,93 @@
+#include "rng.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @file rng.c
+ * Implements the xoshiro256** random number generator.
+ */
+
+/**
+ * Helper function to advance a SplitMix64 state and return the next value.
+ * Used to expand a single 64-bit seed into the full generator state.
+ */
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Helper function to rotate a 64-bit value left by k bits.
+ */
+static inline uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Seeds a generator. The same seed always gives the same sequence on every machine.
+ */
+void rng_seed(Rng *rng, uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        rng->state[i] = splitmix64(&seed);
+    }
+}
+
+/**
+ * Returns the next 64-bit random value from the generator.
+ */
+uint64_t rng_next(Rng *rng)
+{
+    uint64_t *s = rng->state;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+/**
+ * Returns a uniformly distributed random number from 0 to bound - 1.
+ * Uses Lemire's multiply-and-reject method, so there is no modulo bias.
+ */
+uint32_t rng_below(Rng *rng, uint32_t bound)
+{
+    uint64_t product = (rng_next(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)product;
+    if (low < bound)
+    {
+        // Reject the few values that would make some results more likely than others
+        uint32_t threshold = -bound % bound;
+        while (low < threshold)
+        {
+            product = (rng_next(rng) >> 32) * bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+/**
+ * Returns a fresh seed for games that do not ask for a specific deal.
+ * Combines the current time with a counter so that games created
+ * in the same instant still get different seeds.
+ */
+uint64_t random_seed()
+{
+    static atomic_uint_fast64_t counter = 0;
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    uint64_t mix = ((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec) ^
+                   (atomic_fetch_add(&counter, 1) * 0xD1B54A32D192ED03ULL);
+    return splitmix64(&mix);
+}
@@ -0,0 +1,26 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/**
+ * @file rng.h
+ * Defines a small reentrant random number generator (xoshiro256**).
+ * Every game keeps its own generator state, so games can be dealt from
+ * many threads at once and a given seed always produces the same deal.
+ */
+
+/**
+ * Represents the state of a random number generator.
+ */
+typedef struct
+{
+    uint64_t state[4];
+} Rng;
+
+void rng_seed(Rng *rng, uint64_t seed);
+uint64_t rng_next(Rng *rng);
+uint32_t rng_below(Rng *rng, uint32_t bound);
+uint64_t random_seed();
+
+#endif // RNG_H
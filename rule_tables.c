@@ -0,0 +1,287 @@
+// Generated by tools/gen_rule_tables.c from rules.c. Do not edit; regenerate instead (see the README).
+#include "rule_tables.h"
+#include <stdint.h>
+
+/**
+ * @file rule_tables.c
+ * Holds the generated placement tables declared in rule_tables.h.
+ */
+
+const uint64_t tableau_rule_table[RULE_TABLE_ROWS] = {
+    0x0000000000000ULL, // Rank 1 of Hearts
+    0x0008004000000ULL, // Rank 2 of Hearts
+    0x0010008000000ULL, // Rank 3 of Hearts
+    0x0020010000000ULL, // Rank 4 of Hearts
+    0x0040020000000ULL, // Rank 5 of Hearts
+    0x0080040000000ULL, // Rank 6 of Hearts
+    0x0100080000000ULL, // Rank 7 of Hearts
+    0x0200100000000ULL, // Rank 8 of Hearts
+    0x0400200000000ULL, // Rank 9 of Hearts
+    0x0800400000000ULL, // Rank 10 of Hearts
+    0x1000800000000ULL, // Rank 11 of Hearts
+    0x2001000000000ULL, // Rank 12 of Hearts
+    0x4002000000000ULL, // Rank 13 of Hearts
+    0x0000000000000ULL, // Rank 1 of Diamonds
+    0x0008004000000ULL, // Rank 2 of Diamonds
+    0x0010008000000ULL, // Rank 3 of Diamonds
+    0x0020010000000ULL, // Rank 4 of Diamonds
+    0x0040020000000ULL, // Rank 5 of Diamonds
+    0x0080040000000ULL, // Rank 6 of Diamonds
+    0x0100080000000ULL, // Rank 7 of Diamonds
+    0x0200100000000ULL, // Rank 8 of Diamonds
+    0x0400200000000ULL, // Rank 9 of Diamonds
+    0x0800400000000ULL, // Rank 10 of Diamonds
+    0x1000800000000ULL, // Rank 11 of Diamonds
+    0x2001000000000ULL, // Rank 12 of Diamonds
+    0x4002000000000ULL, // Rank 13 of Diamonds
+    0x0000000000000ULL, // Rank 1 of Clubs
+    0x0000000002001ULL, // Rank 2 of Clubs
+    0x0000000004002ULL, // Rank 3 of Clubs
+    0x0000000008004ULL, // Rank 4 of Clubs
+    0x0000000010008ULL, // Rank 5 of Clubs
+    0x0000000020010ULL, // Rank 6 of Clubs
+    0x0000000040020ULL, // Rank 7 of Clubs
+    0x0000000080040ULL, // Rank 8 of Clubs
+    0x0000000100080ULL, // Rank 9 of Clubs
+    0x0000000200100ULL, // Rank 10 of Clubs
+    0x0000000400200ULL, // Rank 11 of Clubs
+    0x0000000800400ULL, // Rank 12 of Clubs
+    0x0000001000800ULL, // Rank 13 of Clubs
+    0x0000000000000ULL, // Rank 1 of Spades
+    0x0000000002001ULL, // Rank 2 of Spades
+    0x0000000004002ULL, // Rank 3 of Spades
+    0x0000000008004ULL, // Rank 4 of Spades
+    0x0000000010008ULL, // Rank 5 of Spades
+    0x0000000020010ULL, // Rank 6 of Spades
+    0x0000000040020ULL, // Rank 7 of Spades
+    0x0000000080040ULL, // Rank 8 of Spades
+    0x0000000100080ULL, // Rank 9 of Spades
+    0x0000000200100ULL, // Rank 10 of Spades
+    0x0000000400200ULL, // Rank 11 of Spades
+    0x0000000800400ULL, // Rank 12 of Spades
+    0x0000001000800ULL, // Rank 13 of Spades
+    0x8004002001000ULL, // Empty pile
+};
+
+const uint64_t foundation_rule_table[NUM_SUITS][RULE_TABLE_ROWS] = {
+    {
+        0x0000000000002ULL, // Rank 1 of Hearts
+        0x0000000000004ULL, // Rank 2 of Hearts
+        0x0000000000008ULL, // Rank 3 of Hearts
+        0x0000000000010ULL, // Rank 4 of Hearts
+        0x0000000000020ULL, // Rank 5 of Hearts
+        0x0000000000040ULL, // Rank 6 of Hearts
+        0x0000000000080ULL, // Rank 7 of Hearts
+        0x0000000000100ULL, // Rank 8 of Hearts
+        0x0000000000200ULL, // Rank 9 of Hearts
+        0x0000000000400ULL, // Rank 10 of Hearts
+        0x0000000000800ULL, // Rank 11 of Hearts
+        0x0000000001000ULL, // Rank 12 of Hearts
+        0x0000000000000ULL, // Rank 13 of Hearts
+        0x0000000000000ULL, // Rank 1 of Diamonds
+        0x0000000000000ULL, // Rank 2 of Diamonds
+        0x0000000000000ULL, // Rank 3 of Diamonds
+        0x0000000000000ULL, // Rank 4 of Diamonds
+        0x0000000000000ULL, // Rank 5 of Diamonds
+        0x0000000000000ULL, // Rank 6 of Diamonds
+        0x0000000000000ULL, // Rank 7 of Diamonds
+        0x0000000000000ULL, // Rank 8 of Diamonds
+        0x0000000000000ULL, // Rank 9 of Diamonds
+        0x0000000000000ULL, // Rank 10 of Diamonds
+        0x0000000000000ULL, // Rank 11 of Diamonds
+        0x0000000000000ULL, // Rank 12 of Diamonds
+        0x0000000000000ULL, // Rank 13 of Diamonds
+        0x0000000000000ULL, // Rank 1 of Clubs
+        0x0000000000000ULL, // Rank 2 of Clubs
+        0x0000000000000ULL, // Rank 3 of Clubs
+        0x0000000000000ULL, // Rank 4 of Clubs
+        0x0000000000000ULL, // Rank 5 of Clubs
+        0x0000000000000ULL, // Rank 6 of Clubs
+        0x0000000000000ULL, // Rank 7 of Clubs
+        0x0000000000000ULL, // Rank 8 of Clubs
+        0x0000000000000ULL, // Rank 9 of Clubs
+        0x0000000000000ULL, // Rank 10 of Clubs
+        0x0000000000000ULL, // Rank 11 of Clubs
+        0x0000000000000ULL, // Rank 12 of Clubs
+        0x0000000000000ULL, // Rank 13 of Clubs
+        0x0000000000000ULL, // Rank 1 of Spades
+        0x0000000000000ULL, // Rank 2 of Spades
+        0x0000000000000ULL, // Rank 3 of Spades
+        0x0000000000000ULL, // Rank 4 of Spades
+        0x0000000000000ULL, // Rank 5 of Spades
+        0x0000000000000ULL, // Rank 6 of Spades
+        0x0000000000000ULL, // Rank 7 of Spades
+        0x0000000000000ULL, // Rank 8 of Spades
+        0x0000000000000ULL, // Rank 9 of Spades
+        0x0000000000000ULL, // Rank 10 of Spades
+        0x0000000000000ULL, // Rank 11 of Spades
+        0x0000000000000ULL, // Rank 12 of Spades
+        0x0000000000000ULL, // Rank 13 of Spades
+        0x0000000000001ULL, // Empty pile
+    },
+    {
+        0x0000000000000ULL, // Rank 1 of Hearts
+        0x0000000000000ULL, // Rank 2 of Hearts
+        0x0000000000000ULL, // Rank 3 of Hearts
+        0x0000000000000ULL, // Rank 4 of Hearts
+        0x0000000000000ULL, // Rank 5 of Hearts
+        0x0000000000000ULL, // Rank 6 of Hearts
+        0x0000000000000ULL, // Rank 7 of Hearts
+        0x0000000000000ULL, // Rank 8 of Hearts
+        0x0000000000000ULL, // Rank 9 of Hearts
+        0x0000000000000ULL, // Rank 10 of Hearts
+        0x0000000000000ULL, // Rank 11 of Hearts
+        0x0000000000000ULL, // Rank 12 of Hearts
+        0x0000000000000ULL, // Rank 13 of Hearts
+        0x0000000004000ULL, // Rank 1 of Diamonds
+        0x0000000008000ULL, // Rank 2 of Diamonds
+        0x0000000010000ULL, // Rank 3 of Diamonds
+        0x0000000020000ULL, // Rank 4 of Diamonds
+        0x0000000040000ULL, // Rank 5 of Diamonds
+        0x0000000080000ULL, // Rank 6 of Diamonds
+        0x0000000100000ULL, // Rank 7 of Diamonds
+        0x0000000200000ULL, // Rank 8 of Diamonds
+        0x0000000400000ULL, // Rank 9 of Diamonds
+        0x0000000800000ULL, // Rank 10 of Diamonds
+        0x0000001000000ULL, // Rank 11 of Diamonds
+        0x0000002000000ULL, // Rank 12 of Diamonds
+        0x0000000000000ULL, // Rank 13 of Diamonds
+        0x0000000000000ULL, // Rank 1 of Clubs
+        0x0000000000000ULL, // Rank 2 of Clubs
+        0x0000000000000ULL, // Rank 3 of Clubs
+        0x0000000000000ULL, // Rank 4 of Clubs
+        0x0000000000000ULL, // Rank 5 of Clubs
+        0x0000000000000ULL, // Rank 6 of Clubs
+        0x0000000000000ULL, // Rank 7 of Clubs
+        0x0000000000000ULL, // Rank 8 of Clubs
+        0x0000000000000ULL, // Rank 9 of Clubs
+        0x0000000000000ULL, // Rank 10 of Clubs
+        0x0000000000000ULL, // Rank 11 of Clubs
+        0x0000000000000ULL, // Rank 12 of Clubs
+        0x0000000000000ULL, // Rank 13 of Clubs
+        0x0000000000000ULL, // Rank 1 of Spades
+        0x0000000000000ULL, // Rank 2 of Spades
+        0x0000000000000ULL, // Rank 3 of Spades
+        0x0000000000000ULL, // Rank 4 of Spades
+        0x0000000000000ULL, // Rank 5 of Spades
+        0x0000000000000ULL, // Rank 6 of Spades
+        0x0000000000000ULL, // Rank 7 of Spades
+        0x0000000000000ULL, // Rank 8 of Spades
+        0x0000000000000ULL, // Rank 9 of Spades
+        0x0000000000000ULL, // Rank 10 of Spades
+        0x0000000000000ULL, // Rank 11 of Spades
+        0x0000000000000ULL, // Rank 12 of Spades
+        0x0000000000000ULL, // Rank 13 of Spades
+        0x0000000002000ULL, // Empty pile
+    },
+    {
+        0x0000000000000ULL, // Rank 1 of Hearts
+        0x0000000000000ULL, // Rank 2 of Hearts
+        0x0000000000000ULL, // Rank 3 of Hearts
+        0x0000000000000ULL, // Rank 4 of Hearts
+        0x0000000000000ULL, // Rank 5 of Hearts
+        0x0000000000000ULL, // Rank 6 of Hearts
+        0x0000000000000ULL, // Rank 7 of Hearts
+        0x0000000000000ULL, // Rank 8 of Hearts
+        0x0000000000000ULL, // Rank 9 of Hearts
+        0x0000000000000ULL, // Rank 10 of Hearts
+        0x0000000000000ULL, // Rank 11 of Hearts
+        0x0000000000000ULL, // Rank 12 of Hearts
+        0x0000000000000ULL, // Rank 13 of Hearts
+        0x0000000000000ULL, // Rank 1 of Diamonds
+        0x0000000000000ULL, // Rank 2 of Diamonds
+        0x0000000000000ULL, // Rank 3 of Diamonds
+        0x0000000000000ULL, // Rank 4 of Diamonds
+        0x0000000000000ULL, // Rank 5 of Diamonds
+        0x0000000000000ULL, // Rank 6 of Diamonds
+        0x0000000000000ULL, // Rank 7 of Diamonds
+        0x0000000000000ULL, // Rank 8 of Diamonds
+        0x0000000000000ULL, // Rank 9 of Diamonds
+        0x0000000000000ULL, // Rank 10 of Diamonds
+        0x0000000000000ULL, // Rank 11 of Diamonds
+        0x0000000000000ULL, // Rank 12 of Diamonds
+        0x0000000000000ULL, // Rank 13 of Diamonds
+        0x0000008000000ULL, // Rank 1 of Clubs
+        0x0000010000000ULL, // Rank 2 of Clubs
+        0x0000020000000ULL, // Rank 3 of Clubs
+        0x0000040000000ULL, // Rank 4 of Clubs
+        0x0000080000000ULL, // Rank 5 of Clubs
+        0x0000100000000ULL, // Rank 6 of Clubs
+        0x0000200000000ULL, // Rank 7 of Clubs
+        0x0000400000000ULL, // Rank 8 of Clubs
+        0x0000800000000ULL, // Rank 9 of Clubs
+        0x0001000000000ULL, // Rank 10 of Clubs
+        0x0002000000000ULL, // Rank 11 of Clubs
+        0x0004000000000ULL, // Rank 12 of Clubs
+        0x0000000000000ULL, // Rank 13 of Clubs
+        0x0000000000000ULL, // Rank 1 of Spades
+        0x0000000000000ULL, // Rank 2 of Spades
+        0x0000000000000ULL, // Rank 3 of Spades
+        0x0000000000000ULL, // Rank 4 of Spades
+        0x0000000000000ULL, // Rank 5 of Spades
+        0x0000000000000ULL, // Rank 6 of Spades
+        0x0000000000000ULL, // Rank 7 of Spades
+        0x0000000000000ULL, // Rank 8 of Spades
+        0x0000000000000ULL, // Rank 9 of Spades
+        0x0000000000000ULL, // Rank 10 of Spades
+        0x0000000000000ULL, // Rank 11 of Spades
+        0x0000000000000ULL, // Rank 12 of Spades
+        0x0000000000000ULL, // Rank 13 of Spades
+        0x0000004000000ULL, // Empty pile
+    },
+    {
+        0x0000000000000ULL, // Rank 1 of Hearts
+        0x0000000000000ULL, // Rank 2 of Hearts
+        0x0000000000000ULL, // Rank 3 of Hearts
+        0x0000000000000ULL, // Rank 4 of Hearts
+        0x0000000000000ULL, // Rank 5 of Hearts
+        0x0000000000000ULL, // Rank 6 of Hearts
+        0x0000000000000ULL, // Rank 7 of Hearts
+        0x0000000000000ULL, // Rank 8 of Hearts
+        0x0000000000000ULL, // Rank 9 of Hearts
+        0x0000000000000ULL, // Rank 10 of Hearts
+        0x0000000000000ULL, // Rank 11 of Hearts
+        0x0000000000000ULL, // Rank 12 of Hearts
+        0x0000000000000ULL, // Rank 13 of Hearts
+        0x0000000000000ULL, // Rank 1 of Diamonds
+        0x0000000000000ULL, // Rank 2 of Diamonds
+        0x0000000000000ULL, // Rank 3 of Diamonds
+        0x0000000000000ULL, // Rank 4 of Diamonds
+        0x0000000000000ULL, // Rank 5 of Diamonds
+        0x0000000000000ULL, // Rank 6 of Diamonds
+        0x0000000000000ULL, // Rank 7 of Diamonds
+        0x0000000000000ULL, // Rank 8 of Diamonds
+        0x0000000000000ULL, // Rank 9 of Diamonds
+        0x0000000000000ULL, // Rank 10 of Diamonds
+        0x0000000000000ULL, // Rank 11 of Diamonds
+        0x0000000000000ULL, // Rank 12 of Diamonds
+        0x0000000000000ULL, // Rank 13 of Diamonds
+        0x0000000000000ULL, // Rank 1 of Clubs
+        0x0000000000000ULL, // Rank 2 of Clubs
+        0x0000000000000ULL, // Rank 3 of Clubs
+        0x0000000000000ULL, // Rank 4 of Clubs
+        0x0000000000000ULL, // Rank 5 of Clubs
+        0x0000000000000ULL, // Rank 6 of Clubs
+        0x0000000000000ULL, // Rank 7 of Clubs
+        0x0000000000000ULL, // Rank 8 of Clubs
+        0x0000000000000ULL, // Rank 9 of Clubs
+        0x0000000000000ULL, // Rank 10 of Clubs
+        0x0000000000000ULL, // Rank 11 of Clubs
+        0x0000000000000ULL, // Rank 12 of Clubs
+        0x0000000000000ULL, // Rank 13 of Clubs
+        0x0010000000000ULL, // Rank 1 of Spades
+        0x0020000000000ULL, // Rank 2 of Spades
+        0x0040000000000ULL, // Rank 3 of Spades
+        0x0080000000000ULL, // Rank 4 of Spades
+        0x0100000000000ULL, // Rank 5 of Spades
+        0x0200000000000ULL, // Rank 6 of Spades
+        0x0400000000000ULL, // Rank 7 of Spades
+        0x0800000000000ULL, // Rank 8 of Spades
+        0x1000000000000ULL, // Rank 9 of Spades
+        0x2000000000000ULL, // Rank 10 of Spades
+        0x4000000000000ULL, // Rank 11 of Spades
+        0x8000000000000ULL, // Rank 12 of Spades
+        0x0000000000000ULL, // Rank 13 of Spades
+        0x0008000000000ULL, // Empty pile
+    },
+};
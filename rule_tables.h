@@ -0,0 +1,46 @@
+#ifndef RULE_TABLES_H
+#define RULE_TABLES_H
+
+#include "cards.h"
+#include "constants.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file rule_tables.h
+ * Defines the placement rules of rules.c as precomputed bit tables, so a rule check is a single load.
+ * The tables in rule_tables.c are generated from rules.c by tools/gen_rule_tables.c
+ * (see the README to regenerate them), and a test checks that they still agree.
+ * Row DECK_SIZE of each table stands for an empty pile (the "null" card with rank 0).
+ */
+
+#define RULE_TABLE_ROWS (DECK_SIZE + 1)
+
+extern const uint64_t tableau_rule_table[RULE_TABLE_ROWS];                // By top card: the cards that fit on it
+extern const uint64_t foundation_rule_table[NUM_SUITS][RULE_TABLE_ROWS]; // By suit and top card
+
+/**
+ * Returns the table row for a pile's top card, DECK_SIZE for the "null" card of an empty pile.
+ */
+static inline int get_rule_table_row(Card top_card)
+{
+    return top_card.rank == 0 ? DECK_SIZE : get_card_index(top_card);
+}
+
+/**
+ * Same result as can_place_on_tableau for valid cards, with one load.
+ */
+static inline bool fits_on_tableau(Card card, Card top_card)
+{
+    return (tableau_rule_table[get_rule_table_row(top_card)] >> get_card_index(card)) & 1;
+}
+
+/**
+ * Same result as can_place_on_foundation for valid cards, with one load.
+ */
+static inline bool fits_on_foundation(Card card, Card top_card, Suit foundation_suit)
+{
+    return (foundation_rule_table[foundation_suit][get_rule_table_row(top_card)] >> get_card_index(card)) & 1;
+}
+
+#endif // RULE_TABLES_H
@@ -0,0 +1,51 @@
+/**
+ * @file server.c
+ * Entry point for yukon-server, which hosts many game sessions in one process
+ * on a Unix domain socket (see sessions.h for the protocol).
+ *
+ * Usage: yukon-server <socket_path> [--max-sessions N]
+ *
+ * A single thread serves all connections with epoll. "hint" searches for at most
+ * SERVER_MAX_HINT_US whatever budget it asks for, since no other command is served meanwhile.
+ */
+
+#include "sessions.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <socket_path> [--max-sessions N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    uint32_t max_sessions = DEFAULT_MAX_SESSIONS;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--max-sessions") == 0)
+            max_sessions = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    }
+
+    static Server server;
+    if (!init_server(&server, max_sessions))
+    {
+        fprintf(stderr, "Failed to allocate %u sessions\n", max_sessions);
+        return EXIT_FAILURE;
+    }
+    if (!listen_on_socket(&server, argv[1]))
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", argv[1], strerror(errno));
+        return EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    while (serve_events(&server, -1))
+        ;
+    perror("epoll_wait");
+    destroy_server(&server);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,390 @@
+#define _GNU_SOURCE // accept4 and fopencookie
+#include "sessions.h"
+#include "board.h"
+#include "pool.h"
+#include "protocol.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @file sessions.c
+ * Implements the session host: a session table filled from the bottom with a free list, boards from a BoardPool,
+ * and an epoll loop over non-blocking connections with buffered input and output.
+ */
+
+#define SERVER_INPUT_SIZE 65536       // Bytes read from a connection at a time; also the longest accepted line
+#define SERVER_OUTPUT_LIMIT (1 << 20) // Pending response bytes above which a connection is not read from
+#define SERVER_MAX_EVENTS 256         // Events taken from epoll at a time
+
+/**
+ * Represents a client connection.
+ */
+typedef struct Connection
+{
+    int fd;
+    char input[SERVER_INPUT_SIZE + 1];
+    size_t input_length; // Bytes in input not handled yet
+    bool skipping;       // Whether the rest of an over-long line is being dropped
+    char *output;        // Responses not sent yet, from output_sent to output_length
+    size_t output_length;
+    size_t output_sent;
+    size_t output_capacity;
+    FILE *stream;        // Writes into output
+    uint32_t sessions;   // First session created by this connection
+    uint32_t events;     // Events epoll is waiting for
+    struct Connection *previous, *next; // Neighbours in the server's list of connections
+} Connection;
+
+/**
+ * Helper function for the connection stream: appends responses to the output buffer.
+ */
+static ssize_t append_output(void *cookie, const char *data, size_t size)
+{
+    Connection *connection = cookie;
+    if (connection->output_length + size > connection->output_capacity)
+    {
+        size_t capacity = connection->output_capacity * 2;
+        while (capacity < connection->output_length + size)
+            capacity *= 2;
+        char *output = realloc(connection->output, capacity);
+        if (output == NULL)
+            return -1;
+        connection->output = output;
+        connection->output_capacity = capacity;
+    }
+    memcpy(connection->output + connection->output_length, data, size);
+    connection->output_length += size;
+    return (ssize_t)size;
+}
+
+/**
+ * Helper function to start a session for a connection.
+ * Returns NO_SESSION if the server is full.
+ */
+static uint32_t open_session(Server *server, Connection *connection, uint64_t seed)
+{
+    // Reuse a freed slot, or else take the first slot never used
+    uint32_t id = server->free_sessions != NO_SESSION ? server->free_sessions : server->used_sessions;
+    if (id == server->max_sessions)
+        return NO_SESSION;
+    Board *board = board_pool_acquire(&server->pool);
+    if (board == NULL)
+        return NO_SESSION;
+    Session *session = &server->sessions[id];
+    if (id == server->free_sessions)
+        server->free_sessions = session->next;
+    else
+        server->used_sessions++;
+    init_engine(&session->engine, board);
+    session->engine.max_hint_budget_us = SERVER_MAX_HINT_US;
+    initialize_board_from_seed(board, seed);
+    session->owner = connection->fd;
+    session->next = connection->sessions;
+    connection->sessions = id;
+    return id;
+}
+
+/**
+ * Helper function to end a session and give its board back to the pool.
+ */
+static void close_session(Server *server, Connection *connection, uint32_t id)
+{
+    // Unlink it from the connection's list
+    uint32_t *link = &connection->sessions;
+    while (*link != id)
+        link = &server->sessions[*link].next;
+    Session *session = &server->sessions[id];
+    *link = session->next;
+    board_pool_release(&server->pool, session->engine.board);
+    session->owner = -1;
+    session->next = server->free_sessions;
+    server->free_sessions = id;
+}
+
+/**
+ * Helper function to handle one command line from a connection and write its response.
+ */
+static void handle_server_command(Server *server, Connection *connection, char *line)
+{
+    FILE *output = connection->stream;
+    while (*line == ' ' || *line == '\t')
+        line++;
+    if (*line == '\0' || *line == '\r')
+        return; // Blank lines are ignored, as by the engine
+    if (strncmp(line, "create", 6) == 0 && (line[6] == ' ' || line[6] == '\t'))
+    {
+        char *end;
+        unsigned long long seed = strtoull(line + 7, &end, 10);
+        end += strspn(end, " \t\r");
+        if (end == line + 7 || *end != '\0')
+        {
+            fputs("error bad_seed\n", output);
+            return;
+        }
+        uint32_t id = open_session(server, connection, (uint64_t)seed);
+        if (id == NO_SESSION)
+            fputs("error server_full\n", output);
+        else
+            fprintf(output, "session %u\n", id);
+        return;
+    }
+    char *end;
+    unsigned long id = strtoul(line, &end, 10);
+    if (end == line || (*end != ' ' && *end != '\t'))
+    {
+        fputs("error unknown_command\n", output);
+        return;
+    }
+    // Other connections' sessions are not visible
+    if (id >= server->used_sessions || server->sessions[id].owner != connection->fd)
+    {
+        fputs("error no_session\n", output);
+        return;
+    }
+    if (!handle_engine_command(&server->sessions[id].engine, end, output))
+    {
+        close_session(server, connection, (uint32_t)id);
+        fputs("ok\n", output);
+    }
+}
+
+/**
+ * Helper function to send pending responses, and to choose which events to wait for:
+ * nothing is read from a connection while too much of its output is pending.
+ * Returns false if the connection failed.
+ */
+static bool send_output(Server *server, Connection *connection)
+{
+    fflush(connection->stream);
+    while (connection->output_sent < connection->output_length)
+    {
+        ssize_t sent = send(connection->fd, connection->output + connection->output_sent,
+                            connection->output_length - connection->output_sent, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            return false;
+        if (sent <= 0)
+            break;
+        connection->output_sent += (size_t)sent;
+    }
+    if (connection->output_sent == connection->output_length)
+        connection->output_sent = connection->output_length = 0;
+
+    size_t pending = connection->output_length - connection->output_sent;
+    uint32_t events = (pending < SERVER_OUTPUT_LIMIT ? EPOLLIN : 0) | (pending > 0 ? EPOLLOUT : 0);
+    if (events != connection->events)
+    {
+        struct epoll_event event = {.events = events, .data.ptr = connection};
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->events = events;
+    }
+    return true;
+}
+
+/**
+ * Helper function to read from a connection and handle every complete line.
+ * Returns false if the connection is closed or failed.
+ */
+static bool receive_input(Server *server, Connection *connection)
+{
+    ssize_t received = read(connection->fd, connection->input + connection->input_length,
+                            SERVER_INPUT_SIZE - connection->input_length);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return true;
+    if (received <= 0)
+        return false;
+    connection->input_length += (size_t)received;
+
+    char *line = connection->input;
+    char *end;
+    while ((end = memchr(line, '\n', connection->input_length - (size_t)(line - connection->input))) != NULL)
+    {
+        *end = '\0';
+        if (connection->skipping)
+            connection->skipping = false;
+        else
+            handle_server_command(server, connection, line);
+        line = end + 1;
+    }
+    connection->input_length -= (size_t)(line - connection->input);
+    memmove(connection->input, line, connection->input_length);
+
+    // A full buffer without a newline is a line too long to be a command
+    if (connection->input_length == SERVER_INPUT_SIZE)
+    {
+        if (!connection->skipping)
+            fputs("error line_too_long\n", connection->stream);
+        connection->skipping = true;
+        connection->input_length = 0;
+    }
+    return true;
+}
+
+/**
+ * Starts serving a connected stream socket. The server takes ownership of fd
+ * and closes it when the connection ends (or right away if it cannot be served).
+ * Returns false if the connection cannot be served.
+ */
+bool add_connection(Server *server, int fd)
+{
+    Connection *connection = calloc(1, sizeof(Connection));
+    cookie_io_functions_t functions = {.write = append_output};
+    if (connection != NULL)
+    {
+        connection->fd = fd;
+        connection->sessions = NO_SESSION;
+        connection->events = EPOLLIN;
+        connection->output_capacity = 4096;
+        connection->output = malloc(connection->output_capacity);
+        connection->stream = fopencookie(connection, "w", functions);
+    }
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = connection};
+    if (connection == NULL || connection->output == NULL || connection->stream == NULL ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0 ||
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        if (connection != NULL && connection->stream != NULL)
+            fclose(connection->stream);
+        if (connection != NULL)
+            free(connection->output);
+        free(connection);
+        close(fd);
+        return false;
+    }
+    setvbuf(connection->stream, NULL, _IOFBF, 4096);
+    connection->next = server->connections;
+    if (server->connections != NULL)
+        server->connections->previous = connection;
+    server->connections = connection;
+    return true;
+}
+
+/**
+ * Helper function to close a connection and end its sessions.
+ */
+static void close_connection(Server *server, Connection *connection)
+{
+    while (connection->sessions != NO_SESSION)
+        close_session(server, connection, connection->sessions);
+    if (connection->previous != NULL)
+        connection->previous->next = connection->next;
+    else
+        server->connections = connection->next;
+    if (connection->next != NULL)
+        connection->next->previous = connection->previous;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+    close(connection->fd);
+    fclose(connection->stream);
+    free(connection->output);
+    free(connection);
+}
+
+/**
+ * Sets up a server with room for max_sessions sessions and no connections.
+ * Returns false if it cannot be allocated.
+ */
+bool init_server(Server *server, uint32_t max_sessions)
+{
+    memset(server, 0, sizeof(*server));
+    server->listen_fd = -1;
+    server->max_sessions = (max_sessions < 1 || max_sessions >= NO_SESSION) ? DEFAULT_MAX_SESSIONS : max_sessions;
+    // Slots are handed out from the bottom and never written before, so the pages of
+    // slots that were never used stay untouched and a large limit costs little memory
+    server->sessions = calloc(server->max_sessions, sizeof(Session));
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (server->sessions == NULL || server->epoll_fd < 0 ||
+        !init_board_pool(&server->pool, BOARD_POOL_SLAB_SIZE, server->max_sessions))
+    {
+        if (server->epoll_fd >= 0)
+            close(server->epoll_fd);
+        free(server->sessions);
+        return false;
+    }
+    server->used_sessions = 0;
+    server->free_sessions = NO_SESSION;
+    return true;
+}
+
+/**
+ * Accepts connections on a Unix domain socket at path, replacing a stale socket file.
+ * Returns false if the socket cannot be created.
+ */
+bool listen_on_socket(Server *server, const char *path)
+{
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    unlink(path);
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    server->listen_fd = fd;
+    return true;
+}
+
+/**
+ * Waits up to timeout_ms (-1 for no limit) for socket events and handles them:
+ * new connections, commands and pending responses.
+ * Returns false if waiting failed.
+ */
+bool serve_events(Server *server, int timeout_ms)
+{
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    int num_events = epoll_wait(server->epoll_fd, events, SERVER_MAX_EVENTS, timeout_ms);
+    if (num_events < 0)
+        return errno == EINTR;
+    for (int i = 0; i < num_events; i++)
+    {
+        Connection *connection = events[i].data.ptr;
+        if (connection == NULL)
+        {
+            // Accept every waiting connection
+            int fd;
+            while ((fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                add_connection(server, fd);
+            continue;
+        }
+        bool open = true;
+        if (events[i].events & EPOLLIN)
+            open = receive_input(server, connection);
+        else if (events[i].events & (EPOLLHUP | EPOLLERR))
+            open = false;
+        open = open && send_output(server, connection);
+        if (!open)
+            close_connection(server, connection);
+    }
+    return true;
+}
+
+/**
+ * Closes every connection, ending their sessions, and frees the server.
+ */
+void destroy_server(Server *server)
+{
+    while (server->connections != NULL)
+        close_connection(server, server->connections);
+    if (server->listen_fd >= 0)
+        close(server->listen_fd);
+    close(server->epoll_fd);
+    destroy_board_pool(&server->pool);
+    free(server->sessions);
+}
@@ -0,0 +1,64 @@
+#ifndef SESSIONS_H
+#define SESSIONS_H
+
+#include "pool.h"
+#include "protocol.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file sessions.h
+ * Defines a host for many game sessions served over stream sockets from one thread, as used by yukon-server.
+ *
+ * Clients send one command per line:
+ *
+ *   create <seed>      -> session <id> | error server_full   Deals a new game in a new session
+ *   <id> <command>     -> the response of yukon-engine (see protocol.h) for that session
+ *   <id> quit          -> ok                                 Ends the session
+ *
+ * Sessions belong to the connection that created them and end when it closes;
+ * other connections get "error no_session" for them.
+ * Every line gets exactly one response line, in order. Commands may be batched: everything read
+ * from a connection is handled in one go and the responses go back in one write.
+ * Commands run on the serving thread, so "hint" searches for at most SERVER_MAX_HINT_US,
+ * whatever budget it asks for, to keep every other session responsive.
+ */
+
+#define SERVER_MAX_HINT_US 1000 // Longest hint search a session may ask for
+#define DEFAULT_MAX_SESSIONS 65536
+#define NO_SESSION UINT32_MAX
+
+/**
+ * Represents a session slot. A freed slot is on the free list, an open one on its connection's list.
+ */
+typedef struct
+{
+    Engine engine;
+    int owner;     // File descriptor of the connection that created the session, -1 if free
+    uint32_t next; // Next session on the same list
+} Session;
+
+struct Connection;
+
+/**
+ * Represents the sessions and connections of a server.
+ */
+typedef struct
+{
+    int epoll_fd;
+    int listen_fd;                  // Listening socket, -1 if connections are only added directly
+    BoardPool pool;                 // Boards of the open sessions
+    Session *sessions;
+    uint32_t max_sessions;
+    uint32_t used_sessions;         // Slots handed out so far; the slots above were never written
+    uint32_t free_sessions;         // First freed session
+    struct Connection *connections; // Open connections
+} Server;
+
+bool init_server(Server *server, uint32_t max_sessions);
+bool listen_on_socket(Server *server, const char *path);
+bool add_connection(Server *server, int fd);
+bool serve_events(Server *server, int timeout_ms);
+void destroy_server(Server *server);
+
+#endif // SESSIONS_H
@@ -0,0 +1,182 @@
+#include "solver.h"
+#include "autoplay.h"
+#include "board.h"
+#include "deadlock.h"
+#include "moves.h"
+#include "transposition.h"
+#include "win.h"
+#include <stdbool.h>
+
+/**
+ * @file solver.c
+ * Implements a depth-first solver with a transposition table.
+ * Positions are made and unmade in place with apply_move / undo_move,
+ * and every position searched is added to the transposition table
+ * so it is never searched twice.
+ * After every move, safe cards are sent to the foundations (see autoplay.h),
+ * so the search never branches on moves that cannot hurt.
+ * With face-down cards known, positions that is_position_dead proves lost are cut off
+ * without generating their moves.
+ */
+
+/**
+ * Default size of the transposition table used when the caller does not pass one
+ * (2^20 slots, 8 MB).
+ */
+#define DEFAULT_TABLE_LOG2_ENTRIES 20
+
+/**
+ * Holds the state of one search.
+ */
+typedef struct
+{
+    Board board;               // Working copy of the board, changed in place during the search
+    SolveMode mode;            // Whether face-down cards are known
+    uint64_t max_nodes;        // Node limit
+    uint64_t nodes;            // Number of positions searched so far
+    uint64_t reveals;          // Number of face-down cards turned over so far
+    bool truncated;            // Whether any line was cut off at MAX_SOLUTION_MOVES
+    TranspositionTable *table; // Visited positions
+    SolveResult *result;       // Where the winning sequence is written
+} Solver;
+
+/**
+ * Searches the current position depth first.
+ * On a win, the winning moves are written to the result from this depth down.
+ */
+static SolveStatus search(Solver *solver, int depth)
+{
+    if (depth >= MAX_SOLUTION_MOVES)
+    {
+        // The line is too long to record, so a later loss is not a proof
+        solver->truncated = true;
+        return SOLVE_LOST;
+    }
+    if (check_win_condition(&solver->board))
+    {
+        solver->result->num_moves = depth;
+        return SOLVE_WON;
+    }
+    if (solver->nodes >= solver->max_nodes)
+        return SOLVE_UNKNOWN;
+    solver->nodes++;
+    // Positions seen before are either on the current line or already lost
+    if (transposition_table_insert(solver->table, solver->board.hash))
+        return SOLVE_LOST;
+    // The check looks at face-down cards, so an honest search must not use it
+    if (solver->mode == SOLVE_FULL_INFORMATION && is_position_dead(&solver->board))
+        return SOLVE_LOST;
+
+    Move moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int num_moves = 0;
+    int num_generated = generate_moves(&solver->board, moves);
+    for (int i = 0; i < num_generated; i++)
+    {
+        Move move = moves[i];
+        int score = score_move(&solver->board, move);
+        if (score < 0)
+            continue;
+        // Insertion sort by descending score (move lists are short)
+        int j = num_moves++;
+        while (j > 0 && scores[j - 1] < score)
+        {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+            j--;
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+
+    for (int i = 0; i < num_moves; i++)
+    {
+        // The move itself, then the cards auto-played after it
+        UndoEntry undo[1 + MAX_AUTOPLAY_MOVES];
+        apply_move(&solver->board, moves[i], &undo[0]);
+        int num_undo = 1 + autoplay_safe_cards(&solver->board, &undo[1]);
+        uint64_t reveals_before = solver->reveals;
+        for (int j = 0; j < num_undo; j++)
+        {
+            if (undo[j].flipped)
+                solver->reveals++;
+        }
+        SolveStatus status = search(solver, depth + num_undo);
+        for (int j = num_undo - 1; j >= 0; j--)
+        {
+            undo_move(&solver->board, &undo[j]);
+        }
+
+        if (status == SOLVE_WON)
+        {
+            // A win is only reported below MAX_SOLUTION_MOVES, so every move fits
+            for (int j = 0; j < num_undo; j++)
+            {
+                solver->result->moves[depth + j] = undo[j].move;
+            }
+            return SOLVE_WON;
+        }
+        if (status == SOLVE_UNKNOWN)
+            return SOLVE_UNKNOWN;
+        // An honest player cannot forget a card once it has been turned over,
+        // so a loss after seeing a new card cannot be taken back to try something else
+        if (solver->mode == SOLVE_HONEST && solver->reveals != reveals_before)
+            return SOLVE_LOST;
+    }
+    return SOLVE_LOST;
+}
+
+/**
+ * Searches for a winning move sequence from the given board.
+ * Stops with SOLVE_UNKNOWN after max_nodes positions.
+ * table may be NULL, in which case a table is allocated for this search.
+ * A table passed in does not need clearing: the search sees it as empty (see start_transposition_search),
+ * so it can be reused across searches without results depending on the searches before.
+ */
+SolveStatus solve_board(const Board *board, SolveMode mode, uint64_t max_nodes,
+                        TranspositionTable *table, SolveResult *result)
+{
+    Solver solver;
+    solver.board = *board;
+    solver.mode = mode;
+    solver.max_nodes = max_nodes;
+    solver.nodes = 0;
+    solver.reveals = 0;
+    solver.truncated = false;
+    solver.result = result;
+    result->num_moves = 0;
+
+    TranspositionTable own_table;
+    if (table == NULL)
+    {
+        if (!create_transposition_table(&own_table, DEFAULT_TABLE_LOG2_ENTRIES))
+        {
+            result->status = SOLVE_UNKNOWN;
+            result->nodes = 0;
+            return SOLVE_UNKNOWN;
+        }
+        solver.table = &own_table;
+    }
+    else
+    {
+        solver.table = table;
+    }
+    start_transposition_search(solver.table);
+
+    // Safe cards in the dealt position go up before the search starts
+    UndoEntry undo[MAX_AUTOPLAY_MOVES];
+    int num_autoplayed = autoplay_safe_cards(&solver.board, undo);
+    for (int i = 0; i < num_autoplayed; i++)
+    {
+        result->moves[i] = undo[i].move;
+    }
+    SolveStatus status = search(&solver, num_autoplayed);
+    if (status == SOLVE_LOST && solver.truncated)
+        status = SOLVE_UNKNOWN;
+
+    if (table == NULL)
+        free_transposition_table(&own_table);
+    result->status = status;
+    result->nodes = solver.nodes;
+    return status;
+}
@@ -0,0 +1,53 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "board.h"
+#include "moves.h"
+#include "transposition.h"
+#include <stdint.h>
+
+/**
+ * @file solver.h
+ * Defines the depth-first solver that decides whether a deal can be won.
+ */
+
+/**
+ * Maximum number of moves in a solution (and maximum search depth).
+ */
+#define MAX_SOLUTION_MOVES 512
+
+/**
+ * Enum representing the outcome of a search.
+ */
+typedef enum
+{
+    SOLVE_WON,    // A winning move sequence was found
+    SOLVE_LOST,   // The search finished without finding a win
+    SOLVE_UNKNOWN // The node limit was reached before the search finished
+} SolveStatus;
+
+/**
+ * Enum representing how much the solver may know about face-down cards.
+ */
+typedef enum
+{
+    SOLVE_FULL_INFORMATION, // Face-down cards are known: SOLVE_LOST proves the deal cannot be won
+    SOLVE_HONEST            // Face-down cards are unknown: the solver never takes back a move after it turned a card over,
+                            // so SOLVE_WON means a player who does not peek could win
+} SolveMode;
+
+/**
+ * Represents the result of a search.
+ */
+typedef struct
+{
+    SolveStatus status;
+    int num_moves;                     // Number of moves in the winning sequence
+    Move moves[MAX_SOLUTION_MOVES];    // Winning move sequence (valid when status is SOLVE_WON)
+    uint64_t nodes;                    // Number of positions searched
+} SolveResult;
+
+SolveStatus solve_board(const Board *board, SolveMode mode, uint64_t max_nodes,
+                        TranspositionTable *table, SolveResult *result);
+
+#endif // SOLVER_H
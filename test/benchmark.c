@@ -0,0 +1,315 @@
+#include "../board.h"
+#include "../cards.h"
+#include "../pile.h"
+#include "../win.h"
+#include "../moves.h"
+#include "../multiboard.h"
+#include "../playout.h"
+#include "../rng.h"
+#include "../record.h"
+#include "../constants.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * Benchmarks for the hot paths of the game.
+ * Each benchmark is run a few times to warm up, then timed over a number of repetitions.
+ * Within a repetition the clock is also read after every small fixed batch of operations
+ * (ops_per_sample, 1 where one operation is long enough to time alone), and each batch's
+ * mean time per operation is kept as a latency sample.
+ * Results are printed as one JSON object per line:
+ * median throughput over the repetitions, and the median and 99th percentile of the samples.
+ *
+ * Usage: benchmark [--reps N] [--warmup N]
+ */
+
+#define MAX_REPS 1000
+#define SCRIPT_MAX_MOVES 200
+
+typedef uint64_t (*BenchFunc)(int ops);
+
+// Written by every benchmark so the compiler cannot drop the work being measured
+volatile uint64_t sink;
+
+// Start position and recorded legal moves for the move benchmark
+Board script_board;
+Move script[SCRIPT_MAX_MOVES];
+Board script_positions[SCRIPT_MAX_MOVES]; // Position before each move of the script
+int script_length;
+
+// Latency samples of the running benchmark: mean time per operation of each batch
+double *samples;
+int num_samples, max_samples;
+int ops_per_sample;
+int ops_in_batch;  // Operations done since the current batch started
+uint64_t batch_start;
+
+uint64_t now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// Starts timing a repetition, and its first batch; returns the start time
+uint64_t start_timing()
+{
+    ops_in_batch = 0;
+    batch_start = now_ns();
+    return batch_start;
+}
+
+// Counts operations done, and records a sample each time a batch is complete
+void count_ops(int ops)
+{
+    ops_in_batch += ops;
+    if (ops_in_batch < ops_per_sample)
+        return;
+    uint64_t now = now_ns();
+    if (num_samples < max_samples)
+        samples[num_samples++] = (double)(now - batch_start) / ops_in_batch;
+    ops_in_batch = 0;
+    batch_start = now;
+}
+
+// Deals: create_deck + shuffle_deck + dealing, through initialize_board_from_seed
+uint64_t bench_deal(int ops)
+{
+    uint64_t start = start_timing();
+    for (int i = 0; i < ops; i++)
+    {
+        Board *board = create_board();
+        initialize_board_from_seed(board, (uint64_t)i);
+        sink += board->tableaus[6].cards[0].rank;
+        free_board(board);
+        count_ops(1);
+    }
+    return now_ns() - start;
+}
+
+// Moves: replay a recorded game through pick_up_cards + place_cards_on_tableau / place_card_on_foundation
+uint64_t bench_moves(int ops)
+{
+    Board board;
+    uint64_t start = start_timing();
+    int done = 0;
+    while (done < ops)
+    {
+        board = script_board;
+        for (int i = 0; i < script_length && done < ops; i++, done++)
+        {
+            pick_up_cards(&board, script[i].from, script[i].count);
+            if (script[i].type == MOVE_TO_TABLEAU)
+                place_cards_on_tableau(&board, script[i].to);
+            else
+                place_card_on_foundation(&board, script[i].to);
+            count_ops(1);
+        }
+        sink += board.hash;
+    }
+    return now_ns() - start;
+}
+
+// Lockstep moves: the recorded game replayed in 64 copies at once, through apply_move on each Board
+uint64_t bench_board_loop_moves(int ops)
+{
+    static Board boards[MULTIBOARD_MAX_LANES];
+    uint64_t start = start_timing();
+    int done = 0;
+    while (done < ops)
+    {
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+            boards[lane] = script_board;
+        for (int i = 0; i < script_length && done < ops; i++, done += MULTIBOARD_MAX_LANES)
+        {
+            for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+                apply_move(&boards[lane], script[i], NULL);
+            count_ops(MULTIBOARD_MAX_LANES);
+        }
+        sink += boards[0].hash;
+    }
+    return now_ns() - start;
+}
+
+// Lockstep moves: the same, through one apply_moves call per move on a 64-lane MultiBoard
+uint64_t bench_multiboard_moves(int ops)
+{
+    static MultiBoard batch;
+    static Move moves[MULTIBOARD_MAX_LANES];
+    init_multiboard(&batch, MULTIBOARD_MAX_LANES);
+    uint64_t start = start_timing();
+    int done = 0;
+    while (done < ops)
+    {
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+            load_lane(&batch, lane, &script_board);
+        for (int i = 0; i < script_length && done < ops; i++, done += MULTIBOARD_MAX_LANES)
+        {
+            for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+                moves[lane] = script[i];
+            sink += apply_moves(&batch, moves, get_all_lanes(&batch), NULL);
+            count_ops(MULTIBOARD_MAX_LANES);
+        }
+    }
+    return now_ns() - start;
+}
+
+// Win checks: check_win_condition on a position that is not won
+uint64_t bench_win_check(int ops)
+{
+    Board board = script_board;
+    uint64_t start = start_timing();
+    for (int i = 0; i < ops; i++)
+    {
+        // Change a foundation each time so the check cannot be hoisted out of the loop
+        board.foundations[i & 3].top = (int8_t)(12 - (i & 1));
+        sink += check_win_condition(&board);
+        count_ops(1);
+    }
+    return now_ns() - start;
+}
+
+// Move generation: generate_moves on every position of the recorded game
+uint64_t bench_generate_moves(int ops)
+{
+    Move moves[MAX_MOVES];
+    uint64_t start = start_timing();
+    int done = 0;
+    while (done < ops)
+    {
+        for (int i = 0; i < script_length && done < ops; i++, done++)
+        {
+            sink += (uint64_t)generate_moves(&script_positions[i], moves);
+            count_ops(1);
+        }
+    }
+    return now_ns() - start;
+}
+
+// Random playouts: whole games with POLICY_RANDOM from a dealt position
+uint64_t bench_playout(int ops)
+{
+    Rng rng;
+    rng_seed(&rng, 1);
+    uint64_t start = start_timing();
+    for (int i = 0; i < ops; i++)
+    {
+        int num_moves;
+        sink += play_out(&script_board, POLICY_RANDOM, &rng, &num_moves);
+        sink += (uint64_t)num_moves;
+        count_ops(1);
+    }
+    return now_ns() - start;
+}
+
+// Record replays: the recorded game stored as a game record, replayed through replay_record
+// (a sample covers a whole replay, since the moves of a record are not timed one by one)
+FILE *script_record;
+
+uint64_t bench_replay(int ops)
+{
+    Board board;
+    uint64_t start = start_timing();
+    int done = 0;
+    while (done < ops)
+    {
+        ReplayResult replay;
+        rewind(script_record);
+        replay_record(script_record, &board, &replay);
+        done += (int)replay.num_moves;
+        sink += board.hash;
+        count_ops((int)replay.num_moves);
+    }
+    return now_ns() - start;
+}
+
+// Records a random legal game from deal 1 for the move benchmark
+void record_script()
+{
+    Board *board = create_board();
+    initialize_board_from_seed(board, 1);
+    script_board = *board;
+    Rng rng;
+    rng_seed(&rng, 1);
+    Move moves[MAX_MOVES];
+    script_length = 0;
+    while (script_length < SCRIPT_MAX_MOVES)
+    {
+        int num_moves = generate_moves(board, moves);
+        if (num_moves == 0)
+            break;
+        Move move = moves[rng_below(&rng, (uint32_t)num_moves)];
+        script_positions[script_length] = *board;
+        apply_move(board, move, NULL);
+        script[script_length++] = move;
+    }
+    free_board(board);
+
+    script_record = tmpfile();
+    RecordWriter writer;
+    open_record_writer(&writer, script_record, 1);
+    for (int i = 0; i < script_length; i++)
+        write_record_move(&writer, script[i]);
+    close_record_writer(&writer);
+}
+
+int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void run_benchmark(const char *name, BenchFunc func, int ops, int sample_ops, int warmup, int reps)
+{
+    static double ns_per_op[MAX_REPS];
+    ops_per_sample = sample_ops;
+    max_samples = reps * (ops / sample_ops + 1);
+    samples = malloc((size_t)max_samples * sizeof(double));
+    if (samples == NULL)
+        return;
+    for (int i = 0; i < warmup; i++)
+        func(ops);
+    // Only the timed repetitions are sampled
+    num_samples = 0;
+    for (int i = 0; i < reps; i++)
+        ns_per_op[i] = (double)func(ops) / ops;
+    qsort(ns_per_op, (size_t)reps, sizeof(double), compare_doubles);
+    qsort(samples, (size_t)num_samples, sizeof(double), compare_doubles);
+    double median = num_samples > 0 ? samples[num_samples / 2] : 0;
+    double p99 = num_samples > 0 ? samples[(int)(0.99 * (num_samples - 1))] : 0;
+    printf("{\"name\":\"%s\",\"reps\":%d,\"ops_per_rep\":%d,\"ops_per_sample\":%d,\"samples\":%d,"
+           "\"median_ops_per_sec\":%.1f,\"median_ns_per_op\":%.2f,\"p99_ns_per_op\":%.2f}\n",
+           name, reps, ops, sample_ops, num_samples, 1e9 / ns_per_op[reps / 2], median, p99);
+    free(samples);
+}
+
+int main(int argc, char **argv)
+{
+    int reps = 30, warmup = 3;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--reps") == 0)
+            reps = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--warmup") == 0)
+            warmup = atoi(argv[i + 1]);
+    }
+    if (reps < 1)
+        reps = 1;
+    if (reps > MAX_REPS)
+        reps = MAX_REPS;
+
+    record_script();
+    run_benchmark("deal", bench_deal, 10000, 1, warmup, reps);
+    run_benchmark("pile_move", bench_moves, 100000, 16, warmup, reps);
+    run_benchmark("record_replay_move", bench_replay, 100000, 16, warmup, reps);
+    run_benchmark("generate_moves", bench_generate_moves, 100000, 16, warmup, reps);
+    run_benchmark("lockstep_board_loop_move", bench_board_loop_moves, 1000000, 64, warmup, reps);
+    run_benchmark("lockstep_multiboard_move", bench_multiboard_moves, 1000000, 64, warmup, reps);
+    run_benchmark("win_check", bench_win_check, 1000000, 64, warmup, reps);
+    run_benchmark("random_playout", bench_playout, 200, 1, warmup, reps);
+    fclose(script_record);
+    return 0;
+}
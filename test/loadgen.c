@@ -0,0 +1,292 @@
+#include "../protocol.h"
+#include "../rng.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Load generator for yukon-server.
+ * Opens a number of sessions spread over a few connections, then plays rounds: every session asks
+ * for its legal moves and applies a random one (or redeals when it has none or has won).
+ * Requests are sent in batches of up to --batch lines per connection, the next batch once the last
+ * one is answered. The latency of a request is the time from sending its batch to receiving its
+ * response, so it includes queueing behind the rest of the batch.
+ * The result is printed as one JSON object.
+ *
+ * Usage: loadgen <socket_path> [--sessions N] [--connections N] [--rounds N] [--batch N] [--seed S]
+ */
+
+#define MAX_LINE_TEXT 32         // Longest request line the load generator sends
+#define LATENCY_BUCKETS 1000000  // Latency histogram buckets of 1 microsecond
+#define READ_SIZE 65536
+
+/**
+ * Represents a phase of a round, which decides the requests sent and how responses are read.
+ */
+typedef enum
+{
+    PHASE_CREATE,
+    PHASE_MOVES,
+    PHASE_APPLY
+} Phase;
+
+/**
+ * Represents a connection and the sessions it plays.
+ */
+typedef struct
+{
+    int fd;
+    uint32_t *session_ids; // Server ids of the sessions
+    char (*next_requests)[MAX_LINE_TEXT]; // Request to send for each session in the apply phase
+    int num_sessions;
+    char *output; // Batch being sent
+    size_t output_length;
+    size_t output_sent;
+    char input[READ_SIZE];
+    size_t input_length;
+    int responses;   // Responses received in the current phase
+    int batch_end;   // Index of the session after the last one in the batch being sent
+    uint64_t sent_ns; // When the batch was sent
+} Client;
+
+static uint64_t latency_histogram[LATENCY_BUCKETS + 1]; // The last bucket counts everything slower
+static uint64_t num_requests, num_errors;
+static int batch_size = 8;
+static Rng rng;
+
+uint64_t now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * Helper function to connect to the server. Returns -1 on failure.
+ */
+static int connect_to(const char *path)
+{
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(address.sun_path))
+        return -1;
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Helper function to handle the response of session i of a client.
+ */
+static void handle_response(Client *client, Phase phase, int i, char *line)
+{
+    if (phase == PHASE_CREATE)
+    {
+        num_errors += sscanf(line, "session %u", &client->session_ids[i]) != 1;
+        return;
+    }
+    if (phase == PHASE_APPLY)
+    {
+        num_errors += strncmp(line, "ok", 2) != 0;
+        return;
+    }
+    // Pick one of the listed moves, or redeal a game that is over
+    int num_moves = 0;
+    char *moves[MAX_MOVES];
+    strtok(line, " ");
+    for (char *move = strtok(NULL, " "); move != NULL && num_moves < MAX_MOVES; move = strtok(NULL, " "))
+        moves[num_moves++] = move;
+    if (num_moves == 0)
+        snprintf(client->next_requests[i], MAX_LINE_TEXT, "%u new %u\n", client->session_ids[i], rng_below(&rng, 1000000));
+    else
+        snprintf(client->next_requests[i], MAX_LINE_TEXT, "%u apply %s\n", client->session_ids[i],
+                 moves[rng_below(&rng, (uint32_t)num_moves)]);
+}
+
+/**
+ * Helper function to build the next batch of requests of a client for a phase.
+ */
+static void build_batch(Client *client, Phase phase)
+{
+    int start = client->batch_end;
+    client->batch_end = start + batch_size < client->num_sessions ? start + batch_size : client->num_sessions;
+    client->output_length = client->output_sent = 0;
+    client->sent_ns = now_ns();
+    for (int i = start; i < client->batch_end; i++)
+    {
+        char *request = client->output + client->output_length;
+        if (phase == PHASE_CREATE)
+            snprintf(request, MAX_LINE_TEXT, "create %u\n", rng_below(&rng, 1000000));
+        else if (phase == PHASE_MOVES)
+            snprintf(request, MAX_LINE_TEXT, "%u moves\n", client->session_ids[i]);
+        else
+            memcpy(request, client->next_requests[i], MAX_LINE_TEXT);
+        client->output_length += strlen(request);
+    }
+}
+
+/**
+ * Sends the request of every session for a phase, batch by batch on every connection,
+ * and reads every response, recording latencies.
+ * Returns false if a connection fails.
+ */
+static bool run_phase(Client *clients, int num_clients, Phase phase)
+{
+    static struct pollfd polls[1024];
+    for (int c = 0; c < num_clients; c++)
+    {
+        clients[c].responses = clients[c].batch_end = 0;
+        build_batch(&clients[c], phase);
+    }
+    int pending = num_clients;
+    while (pending > 0)
+    {
+        for (int c = 0; c < num_clients; c++)
+        {
+            Client *client = &clients[c];
+            polls[c].fd = client->responses < client->num_sessions ? client->fd : -1;
+            polls[c].events = POLLIN | (client->output_sent < client->output_length ? POLLOUT : 0);
+        }
+        if (poll(polls, (nfds_t)num_clients, -1) < 0 && errno != EINTR)
+            return false;
+        for (int c = 0; c < num_clients; c++)
+        {
+            Client *client = &clients[c];
+            if (polls[c].revents & POLLOUT)
+            {
+                ssize_t sent = send(client->fd, client->output + client->output_sent,
+                                    client->output_length - client->output_sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (sent > 0)
+                    client->output_sent += (size_t)sent;
+            }
+            if (!(polls[c].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            ssize_t received = recv(client->fd, client->input + client->input_length,
+                                    READ_SIZE - client->input_length, MSG_DONTWAIT);
+            if (received <= 0)
+                return false;
+            client->input_length += (size_t)received;
+            uint64_t arrived_us = (now_ns() - client->sent_ns) / 1000;
+            char *line = client->input;
+            char *end;
+            while ((end = memchr(line, '\n', client->input_length - (size_t)(line - client->input))) != NULL)
+            {
+                *end = '\0';
+                handle_response(client, phase, client->responses++, line);
+                latency_histogram[arrived_us < LATENCY_BUCKETS ? arrived_us : LATENCY_BUCKETS]++;
+                num_requests++;
+                line = end + 1;
+            }
+            client->input_length -= (size_t)(line - client->input);
+            memmove(client->input, line, client->input_length);
+            if (client->responses == client->num_sessions)
+                pending--;
+            else if (client->responses == client->batch_end)
+                build_batch(client, phase);
+        }
+    }
+    return true;
+}
+
+/**
+ * Helper function to read a percentile from the latency histogram, in microseconds.
+ */
+static uint64_t get_latency_percentile(double percentile)
+{
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)(num_requests - 1));
+    uint64_t seen = 0;
+    for (uint64_t us = 0; us <= LATENCY_BUCKETS; us++)
+    {
+        seen += latency_histogram[us];
+        if (seen > rank)
+            return us;
+    }
+    return LATENCY_BUCKETS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <socket_path> [--sessions N] [--connections N] [--rounds N] [--seed S]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int num_sessions = 50000, num_clients = 16, num_rounds = 20;
+    uint64_t seed = 1;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--sessions") == 0)
+            num_sessions = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--connections") == 0)
+            num_clients = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--rounds") == 0)
+            num_rounds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--batch") == 0)
+            batch_size = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = strtoull(argv[i + 1], NULL, 10);
+    }
+    if (num_clients < 1 || num_clients > 1024)
+        num_clients = 16;
+    if (num_sessions < num_clients)
+        num_sessions = num_clients;
+    if (batch_size < 1)
+        batch_size = 1;
+    rng_seed(&rng, seed);
+
+    Client *clients = calloc((size_t)num_clients, sizeof(Client));
+    for (int c = 0; c < num_clients; c++)
+    {
+        Client *client = &clients[c];
+        client->num_sessions = num_sessions / num_clients + (c < num_sessions % num_clients);
+        client->fd = connect_to(argv[1]);
+        client->session_ids = calloc((size_t)client->num_sessions, sizeof(uint32_t));
+        client->next_requests = calloc((size_t)client->num_sessions, MAX_LINE_TEXT);
+        client->output = malloc((size_t)batch_size * MAX_LINE_TEXT);
+        if (client->fd < 0 || client->session_ids == NULL || client->next_requests == NULL || client->output == NULL)
+        {
+            fprintf(stderr, "Failed to connect to %s: %s\n", argv[1], strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!run_phase(clients, num_clients, PHASE_CREATE))
+    {
+        fprintf(stderr, "Connection lost while creating sessions\n");
+        return EXIT_FAILURE;
+    }
+    // Only the rounds are measured
+    memset(latency_histogram, 0, sizeof(latency_histogram));
+    num_requests = 0;
+    uint64_t start = now_ns();
+    for (int round = 0; round < num_rounds; round++)
+    {
+        if (!run_phase(clients, num_clients, PHASE_MOVES) || !run_phase(clients, num_clients, PHASE_APPLY))
+        {
+            fprintf(stderr, "Connection lost in round %d\n", round);
+            return EXIT_FAILURE;
+        }
+    }
+    double seconds = (double)(now_ns() - start) / 1e9;
+
+    printf("{\"sessions\":%d,\"connections\":%d,\"batch\":%d,\"rounds\":%d,\"requests\":%llu,\"errors\":%llu,"
+           "\"requests_per_sec\":%.1f,\"p50_us\":%llu,\"p99_us\":%llu,\"max_us\":%llu}\n",
+           num_sessions, num_clients, batch_size, num_rounds, (unsigned long long)num_requests, (unsigned long long)num_errors,
+           (double)num_requests / seconds, (unsigned long long)get_latency_percentile(50),
+           (unsigned long long)get_latency_percentile(99), (unsigned long long)get_latency_percentile(100));
+    for (int c = 0; c < num_clients; c++)
+        close(clients[c].fd);
+    return num_errors == 0 ? 0 : EXIT_FAILURE;
+}
@@ -4,8 +4,28 @@
 #include "../win.h"
 #include "../rules.h"
 #include "../constants.h"
+#include "../packed.h"
+#include "../moves.h"
+#include "../rng.h"
+#include "../zobrist.h"
+#include "../solver.h"
+#include "../transposition.h"
+#include "../playout.h"
+#include "../pool.h"
+#include "../record.h"
+#include "../dealdb.h"
+#include "../hint.h"
+#include "../bitboard.h"
+#include "../autoplay.h"
+#include "../canonical.h"
+#include "../deadlock.h"
+#include "../counters.h"
+#include "../multiboard.h"
+#include "../rule_tables.h"
+#include "../protocol.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #define CHECKMARK "\xE2\x9C\x94"
 #define CROSS "\xE2\x9C\x98"
@@ -233,6 +253,919 @@ bool test_auto_turn_facedown_card()
     return result;
 }
 
+// Test 12: Pack a board and unpack it again (should give the same layout)
+bool test_pack_unpack_round_trip()
+{
+    Board *board = create_board();
+    initialize_board(board);
+    // Put an Ace on the Hearts foundation to check foundations are restored too
+    board->foundations[HEARTS].top = 0;
+    board->foundations[HEARTS].cards[0] = (Card){.rank = 1, .suit = HEARTS, .is_face_down = false};
+    PackedBoard packed;
+    bool result = pack_board(board, &packed);
+    Board *copy = create_board();
+    unpack_board(&packed, copy);
+    for (int i = 0; i < NUM_TABLEAUS && result; i++)
+    {
+        result = (copy->tableaus[i].top == board->tableaus[i].top);
+        for (int j = 0; j <= board->tableaus[i].top && result; j++)
+        {
+            Card a = board->tableaus[i].cards[j];
+            Card b = copy->tableaus[i].cards[j];
+            result = compare_cards(a, b) && a.is_face_down == b.is_face_down;
+        }
+    }
+    result = result && copy->foundations[HEARTS].top == 0 && copy->foundations[HEARTS].cards[0].rank == 1;
+    PackedBoard repacked;
+    result = result && pack_board(copy, &repacked) && packed_boards_equal(&packed, &repacked);
+    // Unpacking a smaller position over the full one leaves no stale card locations
+    reset_board(board);
+    board->tableaus[0].top = 0;
+    board->tableaus[0].cards[0] = (Card){.rank = 13, .suit = SPADES, .is_face_down = false};
+    result = result && pack_board(board, &packed);
+    unpack_board(&packed, copy);
+    Board rebuilt = *copy;
+    rebuild_card_locations(&rebuilt);
+    result = result && memcmp(copy->locations, rebuilt.locations, sizeof(copy->locations)) == 0;
+    free_board(copy);
+    free_board(board);
+    return result;
+}
+
+// Test 13: Deal the same seed twice (should give the same deal), and a different seed (should not)
+bool test_deal_from_seed_is_reproducible()
+{
+    Board *board1 = create_board();
+    Board *board2 = create_board();
+    Board *board3 = create_board();
+    initialize_board_from_seed(board1, 42);
+    initialize_board_from_seed(board2, 42);
+    initialize_board_from_seed(board3, 43);
+    PackedBoard packed1, packed2, packed3;
+    pack_board(board1, &packed1);
+    pack_board(board2, &packed2);
+    pack_board(board3, &packed3);
+    bool result = packed_boards_equal(&packed1, &packed2) && !packed_boards_equal(&packed1, &packed3);
+    free_board(board1);
+    free_board(board2);
+    free_board(board3);
+    return result;
+}
+
+// Test 14: List legal moves (should find exactly the two legal moves and leave the board unchanged)
+bool test_generate_moves()
+{
+    Board *board = create_board();
+    // Tableau 0: 5 of Clubs
+    board->tableaus[0].top = 0;
+    board->tableaus[0].cards[0] = (Card){.rank = 5, .suit = CLUBS, .is_face_down = false};
+    // Tableau 1: 7 of Spades, 4 of Hearts
+    board->tableaus[1].top = 1;
+    board->tableaus[1].cards[0] = (Card){.rank = 7, .suit = SPADES, .is_face_down = false};
+    board->tableaus[1].cards[1] = (Card){.rank = 4, .suit = HEARTS, .is_face_down = false};
+    // Tableau 2: Ace of Hearts
+    board->tableaus[2].top = 0;
+    board->tableaus[2].cards[0] = (Card){.rank = 1, .suit = HEARTS, .is_face_down = false};
+    PackedBoard before, after;
+    pack_board(board, &before);
+    Move moves[MAX_MOVES];
+    int num_moves = generate_moves(board, moves);
+    pack_board(board, &after);
+    bool found_tableau_move = false, found_foundation_move = false;
+    for (int i = 0; i < num_moves; i++)
+    {
+        if (moves[i].type == MOVE_TO_TABLEAU && moves[i].from == 1 && moves[i].to == 0 && moves[i].count == 1)
+            found_tableau_move = true;
+        if (moves[i].type == MOVE_TO_FOUNDATION && moves[i].from == 2 && moves[i].to == HEARTS)
+            found_foundation_move = true;
+    }
+    bool result = num_moves == 2 && found_tableau_move && found_foundation_move && packed_boards_equal(&before, &after);
+    free_board(board);
+    return result;
+}
+
+// Test 15: Apply a move that uncovers a face-down card and undo it (should restore the board exactly)
+bool test_apply_and_undo_move_with_flip()
+{
+    Board *board = create_board();
+    // Tableau 0: face-down 9 of Diamonds, 6 of Hearts
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 9, .suit = DIAMONDS, .is_face_down = true};
+    board->tableaus[0].cards[1] = (Card){.rank = 6, .suit = HEARTS, .is_face_down = false};
+    // Tableau 1: 7 of Spades
+    board->tableaus[1].top = 0;
+    board->tableaus[1].cards[0] = (Card){.rank = 7, .suit = SPADES, .is_face_down = false};
+    PackedBoard before, after;
+    pack_board(board, &before);
+    UndoEntry undo;
+    Move move = {MOVE_TO_TABLEAU, 0, 1, 1};
+    bool result = apply_move(board, move, &undo) && undo.flipped &&
+                  board->tableaus[1].top == 1 && !board->tableaus[0].cards[0].is_face_down;
+    undo_move(board, &undo);
+    pack_board(board, &after);
+    result = result && packed_boards_equal(&before, &after);
+    // An illegal move should be rejected without changing the board
+    Move illegal = {MOVE_TO_TABLEAU, 1, 0, 1};
+    result = result && !apply_move(board, illegal, &undo);
+    pack_board(board, &after);
+    result = result && packed_boards_equal(&before, &after);
+    free_board(board);
+    return result;
+}
+
+// Helper function to check the hash and card locations against a full recomputation
+bool is_board_state_consistent(const Board *board)
+{
+    Board rebuilt = *board;
+    rebuild_card_locations(&rebuilt);
+    return board->hash == compute_board_hash(board) &&
+           memcmp(board->locations, rebuilt.locations, sizeof(board->locations)) == 0;
+}
+
+// Test 16: Play random moves through pile.c and apply_move/undo_move (hash should never drift)
+bool test_incremental_state_matches_full_recomputation()
+{
+    Board *board = create_board();
+    initialize_board_from_seed(board, 7);
+    Rng rng;
+    rng_seed(&rng, 7);
+    bool result = (is_board_state_consistent(board));
+    for (int step = 0; step < 2000 && result; step++)
+    {
+        int from = (int)rng_below(&rng, NUM_TABLEAUS);
+        int num = 1 + (int)rng_below(&rng, 3);
+        switch (rng_below(&rng, 3))
+        {
+        case 0: // Random (often illegal) tableau move through pile.c
+            pick_up_cards(board, from, num);
+            result = (is_board_state_consistent(board));
+            place_cards_on_tableau(board, (int)rng_below(&rng, NUM_TABLEAUS));
+            break;
+        case 1: // Random foundation move through pile.c
+            pick_up_cards(board, from, 1);
+            place_card_on_foundation(board, (int)rng_below(&rng, NUM_SUITS));
+            break;
+        default: // Random legal move through apply_move, sometimes undone
+        {
+            Move moves[MAX_MOVES];
+            int num_moves = generate_moves(board, moves);
+            UndoEntry undo;
+            if (num_moves > 0 && apply_move(board, moves[rng_below(&rng, (uint32_t)num_moves)], &undo) &&
+                rng_below(&rng, 2) == 0)
+            {
+                result = result && (is_board_state_consistent(board));
+                undo_move(board, &undo);
+            }
+            break;
+        }
+        }
+        result = result && (is_board_state_consistent(board));
+    }
+    free_board(board);
+    return result;
+}
+
+// Helper function to fill a foundation from Ace up to the given rank
+void fill_foundation(Board *board, Suit suit, int rank)
+{
+    board->foundations[suit].top = rank - 1;
+    for (int i = 0; i < rank; i++)
+        board->foundations[suit].cards[i] = (Card){.rank = i + 1, .suit = suit, .is_face_down = false};
+}
+
+// Helper function to set up a position that needs tableau moves and a flip to win
+void set_up_nearly_won_board(Board *board)
+{
+    fill_foundation(board, DIAMONDS, 13);
+    fill_foundation(board, CLUBS, 13);
+    fill_foundation(board, HEARTS, 10);
+    fill_foundation(board, SPADES, 10);
+    // Tableau 0: Jack of Hearts under Queen of Spades
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 11, .suit = HEARTS, .is_face_down = false};
+    board->tableaus[0].cards[1] = (Card){.rank = 12, .suit = SPADES, .is_face_down = false};
+    // Tableau 1: face-down Queen of Hearts, Jack of Spades, King of Hearts
+    board->tableaus[1].top = 2;
+    board->tableaus[1].cards[0] = (Card){.rank = 12, .suit = HEARTS, .is_face_down = true};
+    board->tableaus[1].cards[1] = (Card){.rank = 11, .suit = SPADES, .is_face_down = false};
+    board->tableaus[1].cards[2] = (Card){.rank = 13, .suit = HEARTS, .is_face_down = false};
+    // Tableau 3: King of Spades
+    board->tableaus[3].top = 0;
+    board->tableaus[3].cards[0] = (Card){.rank = 13, .suit = SPADES, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+}
+
+// Test 17: Solve a position that needs tableau moves and a flip (should be won, and the moves should win)
+bool test_solver_finds_win()
+{
+    Board *board = create_board();
+    set_up_nearly_won_board(board);
+    static SolveResult solution;
+    bool result = solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) == SOLVE_WON;
+    // Replay the solution to check it really wins
+    for (int i = 0; i < solution.num_moves && result; i++)
+        result = apply_move(board, solution.moves[i], NULL);
+    result = result && check_win_condition(board);
+    free_board(board);
+    return result;
+}
+
+// Test 18: Solve a position where the Ace of Hearts is stuck under the Two of Hearts (should be lost)
+bool test_solver_proves_loss()
+{
+    Board *board = create_board();
+    fill_foundation(board, DIAMONDS, 13);
+    fill_foundation(board, CLUBS, 13);
+    fill_foundation(board, SPADES, 13);
+    // Tableau 0: Ace of Hearts under Two of Hearts (nothing left for the Two to go on)
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 1, .suit = HEARTS, .is_face_down = false};
+    board->tableaus[0].cards[1] = (Card){.rank = 2, .suit = HEARTS, .is_face_down = false};
+    // Tableau 1: King down to Three of Hearts
+    board->tableaus[1].top = 10;
+    for (int i = 0; i <= 10; i++)
+        board->tableaus[1].cards[i] = (Card){.rank = 13 - i, .suit = HEARTS, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+    static SolveResult solution;
+    bool result = solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) == SOLVE_LOST;
+    free_board(board);
+    return result;
+}
+
+// Test 19: Run heuristic playouts from a nearly won position (should win every game and leave the board unchanged)
+bool test_playouts_from_nearly_won_board()
+{
+    Board *board = create_board();
+    set_up_nearly_won_board(board);
+    PackedBoard before, after;
+    pack_board(board, &before);
+    Rng rng;
+    rng_seed(&rng, 1);
+    PlayoutStats stats = {0};
+    run_playouts(board, POLICY_HEURISTIC, 100, &rng, &stats);
+    pack_board(board, &after);
+    bool result = stats.games == 100 && get_win_rate(&stats) == 1.0 && stats.min_win_moves > 0 &&
+                  packed_boards_equal(&before, &after);
+    free_board(board);
+    return result;
+}
+
+// Test 20: Acquire and release pooled boards (should reuse boards and refuse to grow past the limit)
+bool test_board_pool_reuse_and_limit()
+{
+    BoardPool pool;
+    if (!init_board_pool(&pool, 1, BOARD_POOL_SLAB_SIZE))
+        return false;
+    Board *boards[BOARD_POOL_SLAB_SIZE];
+    bool result = true;
+    for (int i = 0; i < BOARD_POOL_SLAB_SIZE && result; i++)
+    {
+        boards[i] = board_pool_acquire(&pool);
+        result = (boards[i] != NULL);
+    }
+    // The pool is at its limit, so acquiring should fail instead of exiting
+    result = result && board_pool_acquire(&pool) == NULL;
+    // A released board should be handed out again, empty
+    initialize_board_from_seed(boards[0], 1);
+    board_pool_release(&pool, boards[0]);
+    Board *reused = board_pool_acquire(&pool);
+    result = result && reused == boards[0] && reused->tableaus[6].top == -1 && pool.in_use == BOARD_POOL_SLAB_SIZE;
+    destroy_board_pool(&pool);
+    return result;
+}
+
+// Test 21: Record a winning game, replay it, and replay a corrupted copy (should win, then be rejected)
+bool test_record_write_and_replay()
+{
+    Board *board = create_board();
+    initialize_board_from_seed(board, 1);
+    static SolveResult solution;
+    if (solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) != SOLVE_WON)
+    {
+        free_board(board);
+        return false;
+    }
+    FILE *file = tmpfile();
+    RecordWriter writer;
+    bool result = open_record_writer(&writer, file, 1);
+    for (int i = 0; i < solution.num_moves; i++)
+        result = result && write_record_move(&writer, solution.moves[i]);
+    result = result && close_record_writer(&writer);
+    rewind(file);
+    ReplayResult replay;
+    result = result && replay_record(file, board, &replay) == REPLAY_OK &&
+             replay.num_moves == (uint32_t)solution.num_moves && check_win_condition(board);
+    // Flip a bit in the first move: the checksum (or the move itself) should no longer match
+    fseek(file, RECORD_HEADER_SIZE, SEEK_SET);
+    int first = getc(file);
+    fseek(file, RECORD_HEADER_SIZE, SEEK_SET);
+    putc(first ^ 0x01, file);
+    rewind(file);
+    result = result && replay_record(file, board, &replay) != REPLAY_OK;
+    fclose(file);
+    free_board(board);
+    return result;
+}
+
+// Test 22: Verify two concatenated records, a win and a game with an illegal first move (should frame both and report the move status)
+bool test_verify_concatenated_records()
+{
+    Board *board = create_board();
+    initialize_board_from_seed(board, 1);
+    static SolveResult solution;
+    if (solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) != SOLVE_WON)
+    {
+        free_board(board);
+        return false;
+    }
+    // Two records back to back: the solution, then a game whose first move picks up a face-down card
+    FILE *file = tmpfile();
+    RecordWriter writer;
+    bool result = open_record_writer(&writer, file, 1);
+    for (int i = 0; i < solution.num_moves; i++)
+        result = result && write_record_move(&writer, solution.moves[i]);
+    result = result && close_record_writer(&writer);
+    result = result && open_record_writer(&writer, file, 2);
+    result = result && write_record_move(&writer, (Move){MOVE_TO_TABLEAU, 1, 2, 6});
+    result = result && close_record_writer(&writer);
+
+    uint8_t bytes[2048];
+    size_t size = (size_t)ftell(file);
+    rewind(file);
+    result = result && size <= sizeof(bytes) && fread(bytes, 1, size, file) == size;
+    fclose(file);
+
+    size_t first_size = get_record_size(bytes, size);
+    result = result && first_size > 0 && first_size < size && get_record_size(bytes + first_size, size - first_size) == size - first_size;
+    ReplayResult replay;
+    result = result && replay_record_buffer(bytes, first_size, board, &replay) == REPLAY_OK &&
+             replay.seed == 1 && check_win_condition(board);
+    // Tableau 1 has one face-down card under five face-up cards
+    result = result && replay_record_buffer(bytes + first_size, size - first_size, board, &replay) == REPLAY_ILLEGAL_MOVE &&
+             replay.seed == 2 && replay.num_moves == 0 && replay.move_status == MOVE_FACE_DOWN_CARD;
+    // A truncated record cannot be framed
+    result = result && get_record_size(bytes, first_size - 1) == 0;
+    free_board(board);
+    return result;
+}
+
+// Test 23: Build a deal database in two steps and look up seeds (should extend it, match freshly computed records, and pick the same deals by difficulty with and without the index)
+bool test_deal_database_build_and_lookup()
+{
+    const char *path = "test_dealdb.tmp";
+    const char *index_path = "test_dealdb.tmp" DEAL_INDEX_SUFFIX;
+    remove(path);
+    // Build in two steps to check that an existing database is extended, not rebuilt
+    bool result = build_deal_database(path, 100, 3, 20000) && build_deal_database(path, 100, 5, 20000);
+    // A database for a different range cannot be extended
+    result = result && !build_deal_database(path, 0, 5, 20000);
+    DealDatabase database;
+    if (!result || !open_deal_database(&database, path))
+    {
+        remove(path);
+        remove(index_path);
+        return false;
+    }
+    result = database.count == 5 && find_deal(&database, 99) == NULL && find_deal(&database, 105) == NULL;
+    for (uint64_t seed = 100; seed < 105; seed++)
+    {
+        DealRecord expected;
+        compute_deal_record(seed, 20000, NULL, &expected);
+        const DealRecord *record = find_deal(&database, seed);
+        Board dealt, stored;
+        initialize_board_from_seed(&dealt, seed);
+        result = result && record != NULL && record->status == expected.status &&
+                 record->solution_length == expected.solution_length && record->difficulty == expected.difficulty;
+        if (result)
+        {
+            unpack_board(&record->board, &stored);
+            result = stored.hash == dealt.hash;
+        }
+    }
+    uint64_t seed;
+    if (find_deal_by_difficulty(&database, 0, DEAL_UNSOLVED - 1, 103, &seed))
+        result = result && find_deal(&database, seed)->status == SOLVE_WON;
+    // Picks through the difficulty index match a scan of the records, for every range and start
+    DealDatabase unindexed = database;
+    unindexed.index = NULL;
+    result = result && database.index != NULL && database.index->count == 5;
+    for (int low = 0; low <= 20 && result; low++)
+    {
+        for (int high = low; high <= 20 && result; high++)
+        {
+            for (uint64_t start = 98; start < 107 && result; start++)
+            {
+                uint64_t indexed_seed = 0, scanned_seed = 0;
+                bool indexed = find_deal_by_difficulty(&database, (uint8_t)low, (uint8_t)high, start, &indexed_seed);
+                bool scanned = find_deal_by_difficulty(&unindexed, (uint8_t)low, (uint8_t)high, start, &scanned_seed);
+                result = indexed == scanned && indexed_seed == scanned_seed;
+            }
+        }
+    }
+    close_deal_database(&database);
+    remove(path);
+    remove(index_path);
+    return result;
+}
+
+// Test 24: Ask for hints on a nearly won position (should leave the board unchanged, and playing the hints should win)
+bool test_hint_suggests_winning_move_without_changing_board()
+{
+    Board *board = create_board();
+    set_up_nearly_won_board(board);
+    PackedBoard before, after;
+    pack_board(board, &before);
+    uint64_t hash = board->hash;
+    Move move;
+    bool result = suggest_move(board, 5000, &move) && pack_board(board, &after) &&
+                  packed_boards_equal(&before, &after) && board->hash == hash;
+    // Playing the hints should win the nearly won board
+    for (int i = 0; result && i < 20 && !check_win_condition(board); i++)
+    {
+        result = suggest_move(board, 5000, &move) && apply_move(board, move, NULL);
+    }
+    result = result && check_win_condition(board);
+    // With no time at all there is still an answer
+    initialize_board_from_seed(board, 3);
+    result = result && suggest_move(board, 0, &move) && is_legal_move(board, move);
+    free_board(board);
+    return result;
+}
+
+// Test 25: Compare bitboard acceptors and foundation masks with the placement rules (should agree for every card)
+bool test_bitboard_matches_rules()
+{
+    // Every pair of cards: the mask answer must match can_place_on_tableau
+    for (int top_index = 0; top_index < DECK_SIZE; top_index++)
+    {
+        Card top_card = {.rank = (uint8_t)(top_index % 13 + 1), .suit = (uint8_t)(top_index / 13)};
+        CardMask acceptors = get_tableau_acceptors(get_card_mask(top_card));
+        for (int index = 0; index < DECK_SIZE; index++)
+        {
+            Card card = {.rank = (uint8_t)(index % 13 + 1), .suit = (uint8_t)(index / 13)};
+            if (((acceptors & get_card_mask(card)) != 0) != can_place_on_tableau(card, top_card))
+                return false;
+        }
+    }
+    // The foundations accept the card after their top card
+    Board *board = create_board();
+    set_up_nearly_won_board(board);
+    Bitboard bitboard;
+    build_bitboard(board, &bitboard);
+    bool result = true;
+    for (int f = 0; f < NUM_SUITS; f++)
+    {
+        Foundation *foundation = &board->foundations[f];
+        Card next = {.rank = (uint8_t)(foundation->top + 2), .suit = (uint8_t)foundation->suit};
+        result = result && (foundation->top + 1 == FOUNDATION_SIZE || (bitboard.foundation_next & get_card_mask(next)) != 0);
+    }
+    result = result && __builtin_popcountll(bitboard.foundation_next) <= NUM_SUITS;
+    free_board(board);
+    return result;
+}
+
+// Test 26: Auto-play a position with safe and unsafe cards (should move only the safe cards, and undo should restore the board)
+bool test_autoplay_moves_only_safe_cards()
+{
+    Board *board = create_board();
+    fill_foundation(board, HEARTS, 2);
+    fill_foundation(board, DIAMONDS, 1);
+    fill_foundation(board, CLUBS, 2);
+    fill_foundation(board, SPADES, 2);
+    // Tableau 0: 4 of Hearts under 3 of Hearts (safe: both black Twos are up)
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 4, .suit = HEARTS, .is_face_down = false};
+    board->tableaus[0].cards[1] = (Card){.rank = 3, .suit = HEARTS, .is_face_down = false};
+    // Tableau 1: 2 of Diamonds (safe: both black Aces are up)
+    board->tableaus[1].top = 0;
+    board->tableaus[1].cards[0] = (Card){.rank = 2, .suit = DIAMONDS, .is_face_down = false};
+    // Tableau 2: face-down King of Spades under 3 of Clubs (safe once the 2 of Diamonds is up)
+    board->tableaus[2].top = 1;
+    board->tableaus[2].cards[0] = (Card){.rank = 13, .suit = SPADES, .is_face_down = true};
+    board->tableaus[2].cards[1] = (Card){.rank = 3, .suit = CLUBS, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+    PackedBoard before, after;
+    pack_board(board, &before);
+
+    UndoEntry undo[MAX_AUTOPLAY_MOVES];
+    int num_autoplayed = autoplay_safe_cards(board, undo);
+    // The 4 of Hearts stays: the 3 of Spades could still need it
+    bool result = num_autoplayed == 3 && board->foundations[HEARTS].top == 2 && board->foundations[DIAMONDS].top == 1 &&
+                  board->foundations[CLUBS].top == 2 && board->tableaus[0].top == 0 &&
+                  !board->tableaus[2].cards[0].is_face_down && is_board_state_consistent(board);
+    // Undoing the auto-played cards in reverse restores the board exactly
+    for (int i = num_autoplayed - 1; i >= 0; i--)
+        undo_move(board, &undo[i]);
+    result = result && pack_board(board, &after) && packed_boards_equal(&before, &after) && is_board_state_consistent(board);
+    // One undo_last_move takes back a player's move (2 of Diamonds onto 3 of Clubs) and the cards auto-played after it
+    UndoStack undo_stack;
+    init_undo_stack(&undo_stack);
+    UndoEntry player_move;
+    result = result && apply_move(board, (Move){MOVE_TO_TABLEAU, 1, 2, 1}, &player_move);
+    push_undo_entry(&undo_stack, &player_move);
+    num_autoplayed = autoplay_safe_cards(board, undo);
+    for (int i = 0; i < num_autoplayed; i++)
+        push_undo_entry(&undo_stack, &undo[i]);
+    result = result && num_autoplayed > 0 && undo_last_move(&undo_stack, board) == num_autoplayed + 1 &&
+             undo_last_move(&undo_stack, board) == 0;
+    result = result && pack_board(board, &after) && packed_boards_equal(&before, &after) && is_board_state_consistent(board);
+    free_board(board);
+    return result;
+}
+
+// Test 27: Reorder the tableaus and swap two same-colour suits (should give the same canonical form, and a real move should not)
+bool test_equivalent_boards_share_canonical_form()
+{
+    Board *board = create_board();
+    initialize_board_from_seed(board, 11);
+    // Make an empty tableau, so empty tableaus are part of the reordering
+    board->tableaus[0].top = -1;
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+
+    // Reverse the tableaus: the Zobrist hash already ignores their order
+    Board *reordered = create_board();
+    *reordered = *board;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+        reordered->tableaus[t] = board->tableaus[NUM_TABLEAUS - 1 - t];
+    reordered->hash = compute_board_hash(reordered);
+    bool result = reordered->hash == board->hash && are_boards_equivalent(board, reordered);
+
+    // Swap Hearts with Diamonds (cards and foundations): only the canonical form sees through it
+    Board *renamed = create_board();
+    *renamed = *board;
+    for (int t = 0; t < NUM_TABLEAUS; t++)
+    {
+        for (int i = 0; i <= renamed->tableaus[t].top; i++)
+        {
+            Card *card = &renamed->tableaus[t].cards[i];
+            if (card->suit == HEARTS || card->suit == DIAMONDS)
+                card->suit = (card->suit == HEARTS) ? DIAMONDS : HEARTS;
+        }
+    }
+    result = result && are_boards_equivalent(board, renamed) &&
+             get_canonical_hash(board) == get_canonical_hash(renamed);
+
+    // A real move gives a different class
+    Move moves[MAX_MOVES];
+    int num_moves = generate_moves(renamed, moves);
+    result = result && num_moves > 0 && apply_move(renamed, moves[0], NULL) && !are_boards_equivalent(board, renamed);
+    free_board(board);
+    free_board(reordered);
+    free_board(renamed);
+    return result;
+}
+
+// Test 28: Check positions with and without a pinned card (should call only the pinned one dead, and never a fresh deal)
+bool test_dead_positions_are_detected()
+{
+    Board *board = create_board();
+    fill_foundation(board, HEARTS, 2);
+    fill_foundation(board, CLUBS, 6);
+    fill_foundation(board, SPADES, 6);
+    // Tableau 0: face-down 3 of Hearts under 5 of Hearts, which has nowhere to go but up
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 3, .suit = HEARTS, .is_face_down = true};
+    board->tableaus[0].cards[1] = (Card){.rank = 5, .suit = HEARTS, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+    bool result = is_position_dead(board);
+
+    // With the 6 of Clubs back on a tableau the 5 of Hearts can move onto it
+    board->foundations[CLUBS].top = 4;
+    board->tableaus[1].top = 0;
+    board->tableaus[1].cards[0] = (Card){.rank = 6, .suit = CLUBS, .is_face_down = false};
+    rebuild_card_locations(board);
+    result = result && !is_position_dead(board);
+
+    // A King can always wait for an empty tableau, so it is never pinned
+    board->foundations[CLUBS].top = 5;
+    board->tableaus[1].top = -1;
+    board->tableaus[0].cards[1] = (Card){.rank = 13, .suit = HEARTS, .is_face_down = false};
+    rebuild_card_locations(board);
+    result = result && !is_position_dead(board);
+
+    // Nothing is on the foundations of a fresh deal, so no deal is thrown away unsearched
+    for (uint64_t seed = 0; seed < 100 && result; seed++)
+    {
+        initialize_board_from_seed(board, seed);
+        result = !is_position_dead(board);
+    }
+    free_board(board);
+    return result;
+}
+
+// Test 29: Count pile operations on rejected and accepted moves (should count calls, rejections, flips and returned cards exactly)
+bool test_operation_counters()
+{
+    Board *board = create_board();
+    // Tableau 0: face-down 9 of Clubs under 5 of Hearts; tableau 1: 6 of Spades
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 9, .suit = CLUBS, .is_face_down = true};
+    board->tableaus[0].cards[1] = (Card){.rank = 5, .suit = HEARTS, .is_face_down = false};
+    board->tableaus[1].top = 0;
+    board->tableaus[1].cards[0] = (Card){.rank = 6, .suit = SPADES, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+    reset_thread_counters();
+
+    // Rejected: the face-down 9 of Clubs cannot be picked up
+    pick_up_cards(board, 0, 2);
+    // Rejected: the 5 of Hearts does not go on an empty foundation, so it is returned and the 9 of Clubs is hidden again
+    pick_up_cards(board, 0, 1);
+    place_card_on_foundation(board, HEARTS);
+    bool hidden_again = board->tableaus[0].cards[0].is_face_down && board->hash == compute_board_hash(board);
+    // Accepted: the 5 of Hearts onto the 6 of Spades, turning over the 9 of Clubs for good
+    pick_up_cards(board, 0, 1);
+    place_cards_on_tableau(board, 1);
+    check_win_condition(board);
+
+    OperationCounters counters;
+    get_thread_counters(&counters);
+    bool result = hidden_again && counters.calls[OPERATION_PICK_UP] == 3 && counters.calls[OPERATION_PLACE_ON_FOUNDATION] == 1 &&
+                  counters.calls[OPERATION_PLACE_ON_TABLEAU] == 1 && counters.calls[OPERATION_WIN_CHECK] == 1 &&
+                  counters.rejections[OPERATION_PLACE_ON_FOUNDATION][MOVE_RULE_VIOLATION] == 1 &&
+                  counters.rejections[OPERATION_PICK_UP][MOVE_FACE_DOWN_CARD] == 1 &&
+                  counters.rejections[OPERATION_PLACE_ON_TABLEAU][MOVE_OK] == 0 && counters.flips == 1 &&
+                  counters.cards_returned == 1 && counters.wins == 0;
+
+    // Snapshots add up, as when the counters of several threads are combined
+    OperationCounters total = {0};
+    add_counters(&total, &counters);
+    add_counters(&total, &counters);
+    result = result && total.calls[OPERATION_PICK_UP] == 6 && total.flips == 2;
+    reset_thread_counters();
+    get_thread_counters(&counters);
+    result = result && counters.calls[OPERATION_PICK_UP] == 0;
+    free_board(board);
+    return result;
+}
+
+// Test 30: Play random moves in 64 lanes and on single boards (should agree on legality, flips and positions, and win together)
+bool test_multiboard_matches_single_boards()
+{
+    static MultiBoard batch;
+    static Board boards[MULTIBOARD_MAX_LANES];
+    static Move moves[MULTIBOARD_MAX_LANES];
+    init_multiboard(&batch, MULTIBOARD_MAX_LANES);
+    bool result = true;
+    for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+    {
+        initialize_board_from_seed(&boards[lane], (uint64_t)lane);
+        result = result && load_lane(&batch, lane, &boards[lane]);
+    }
+    // Every lane plays its own random moves, some of them illegal, in lockstep with a single board
+    Rng rng;
+    rng_seed(&rng, 5);
+    for (int step = 0; step < 100 && result; step++)
+    {
+        LaneMask expected = 0;
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES; lane++)
+        {
+            Move legal[MAX_MOVES];
+            int num_legal = generate_moves(&boards[lane], legal);
+            if (num_legal > 0 && rng_below(&rng, 4) != 0)
+                moves[lane] = legal[rng_below(&rng, (uint32_t)num_legal)];
+            else
+                moves[lane] = (Move){(uint8_t)rng_below(&rng, 2), (uint8_t)rng_below(&rng, NUM_TABLEAUS),
+                                     (uint8_t)rng_below(&rng, NUM_SUITS), (uint8_t)(1 + rng_below(&rng, 3))};
+            expected |= (LaneMask)is_legal_move(&boards[lane], moves[lane]) << lane;
+            apply_move(&boards[lane], moves[lane], NULL);
+        }
+        result = validate_moves(&batch, moves, get_all_lanes(&batch)) == expected &&
+                 apply_moves(&batch, moves, get_all_lanes(&batch), NULL) == expected;
+        for (int lane = 0; lane < MULTIBOARD_MAX_LANES && result; lane++)
+        {
+            Board stored;
+            PackedBoard a, b;
+            store_lane(&batch, lane, &stored);
+            result = stored.hash == boards[lane].hash && pack_board(&stored, &a) && pack_board(&boards[lane], &b) &&
+                     packed_boards_equal(&a, &b);
+        }
+    }
+
+    // The same winning line played in 8 copies of a nearly won position wins every lane at the end
+    Board *board = create_board();
+    set_up_nearly_won_board(board);
+    rebuild_card_locations(board);
+    static SolveResult solution;
+    result = result && solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) == SOLVE_WON;
+    init_multiboard(&batch, 8);
+    for (int lane = 0; lane < 8; lane++)
+        result = result && load_lane(&batch, lane, board);
+    result = result && get_won_lanes(&batch) == 0;
+    for (int i = 0; i < solution.num_moves && result; i++)
+    {
+        for (int lane = 0; lane < 8; lane++)
+            moves[lane] = solution.moves[i];
+        result = apply_moves(&batch, moves, get_all_lanes(&batch), NULL) == 0xFF;
+    }
+    result = result && get_won_lanes(&batch) == 0xFF;
+    free_board(board);
+    return result;
+}
+
+// Test 31: Look up every card on every top card in the generated tables (should match rules.c)
+bool test_rule_tables_match_rules()
+{
+    bool result = true;
+    // Every card on every top card, including the "null" card of an empty pile
+    for (int row = 0; row <= DECK_SIZE; row++)
+    {
+        Card top_card = {0};
+        if (row < DECK_SIZE)
+            top_card = (Card){.rank = (uint8_t)(row % FOUNDATION_SIZE + 1), .suit = (uint8_t)(row / FOUNDATION_SIZE)};
+        for (int i = 0; i < DECK_SIZE; i++)
+        {
+            Card card = {.rank = (uint8_t)(i % FOUNDATION_SIZE + 1), .suit = (uint8_t)(i / FOUNDATION_SIZE)};
+            result = result && fits_on_tableau(card, top_card) == can_place_on_tableau(card, top_card);
+            for (int suit = 0; suit < NUM_SUITS; suit++)
+            {
+                result = result && fits_on_foundation(card, top_card, (Suit)suit) ==
+                                       can_place_on_foundation(card, top_card, (Suit)suit);
+            }
+        }
+    }
+    return result;
+}
+
+// Test 32: Round-trip positions and moves through text and run pipelined commands (should give one expected response per command)
+bool test_engine_protocol()
+{
+    // Positions and moves survive a round trip through their text form
+    static Engine engine;
+    static Board board;
+    init_engine(&engine, &board);
+    initialize_board_from_seed(engine.board, 7);
+    char text[MAX_POSITION_TEXT], again[MAX_POSITION_TEXT];
+    format_position(engine.board, text);
+    static Board parsed;
+    bool result = parse_position(text, &parsed) && parsed.hash == engine.board->hash &&
+                  memcmp(parsed.locations, engine.board->locations, sizeof(parsed.locations)) == 0;
+    format_position(&parsed, again);
+    result = result && strcmp(text, again) == 0;
+    Move moves[MAX_MOVES];
+    int num_moves = generate_moves(engine.board, moves);
+    for (int i = 0; i < num_moves; i++)
+    {
+        char move_text[MAX_MOVE_TEXT];
+        Move move;
+        format_move(moves[i], move_text);
+        result = result && parse_move(move_text, &move) && move.type == moves[i].type &&
+                 move.from == moves[i].from && move.to == moves[i].to && move.count == moves[i].count;
+    }
+    result = result && !parse_move("8-1", &moves[0]) && !parse_move("1-f5", &moves[0]) && !parse_move("1-2:", &moves[0]);
+    // A position missing a card, or holding one twice, is rejected
+    result = result && !parse_position("0,0,0,0 Ah/2h/3h/4h/5h/6h/7h", &parsed);
+    text[strlen(text) - 2] = text[8]; // The first tableau holds one face-up card
+    text[strlen(text) - 1] = text[9];
+    result = result && !parse_position(text, &parsed);
+
+    // A pipelined session gets one response line per command
+    char first_move[MAX_MOVE_TEXT], commands[512];
+    format_move(moves[0], first_move);
+    snprintf(commands, sizeof(commands), "new 7\nmoves\napply %s\nundo\nundo\napply 1-1\napply x\nfrobnicate\nquit\nget\n",
+             first_move);
+    FILE *file = tmpfile();
+    bool running = true;
+    for (char *line = strtok(commands, "\n"); line != NULL && running; line = strtok(NULL, "\n"))
+        running = handle_engine_command(&engine, line, file);
+    rewind(file);
+    char expected_moves[1024] = "moves";
+    for (int i = 0; i < num_moves; i++)
+    {
+        char move_text[MAX_MOVE_TEXT];
+        format_move(moves[i], move_text);
+        strcat(expected_moves, " ");
+        strcat(expected_moves, move_text);
+    }
+    const char *expected[] = {"ok", expected_moves, "ok", "ok", "error nothing_to_undo", "illegal same_tableau",
+                              "error bad_move", "error unknown_command"};
+    char line[1024];
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+    {
+        result = result && fgets(line, sizeof(line), file) != NULL;
+        line[strcspn(line, "\n")] = '\0';
+        result = result && strcmp(line, expected[i]) == 0;
+    }
+    result = result && !running && fgets(line, sizeof(line), file) == NULL;
+    fclose(file);
+
+    // One undo takes back an apply with all its auto-played cards, and a hint budget must be a number
+    char auto_commands[] = "set 13,13,12,11 Qs/Kc/Ks////\nauto on\napply 2-4\nundo\nget\nhint abc\nhint 12x\n";
+    const char *auto_expected[] = {"ok", "ok", "ok auto 4-f3 1-f4 3-f4 won", "ok", "position 13,13,12,11 Qs/Kc/Ks////",
+                                   "error bad_budget", "error bad_budget"};
+    file = tmpfile();
+    for (char *command = strtok(auto_commands, "\n"); command != NULL; command = strtok(NULL, "\n"))
+        handle_engine_command(&engine, command, file);
+    rewind(file);
+    for (size_t i = 0; i < sizeof(auto_expected) / sizeof(auto_expected[0]); i++)
+    {
+        result = result && fgets(line, sizeof(line), file) != NULL;
+        line[strcspn(line, "\n")] = '\0';
+        result = result && strcmp(line, auto_expected[i]) == 0;
+    }
+    fclose(file);
+    return result;
+}
+
+// Test 33: Solve a position where a black Ace must be carried onto the red Two (the Two should not be auto-played, and the position should be won)
+bool test_autoplay_keeps_two_needed_by_ace()
+{
+    Board *board = create_board();
+    fill_foundation(board, HEARTS, 1);
+    fill_foundation(board, DIAMONDS, 13);
+    fill_foundation(board, SPADES, 13);
+    // Tableau 0: 2 of Hearts
+    board->tableaus[0].top = 0;
+    board->tableaus[0].cards[0] = (Card){.rank = 2, .suit = HEARTS, .is_face_down = false};
+    // Tableau 1: face-down 3 of Hearts under Ace and 2 of Clubs; only moving the Ace onto the 2 of Hearts frees it
+    board->tableaus[1].top = 2;
+    board->tableaus[1].cards[0] = (Card){.rank = 3, .suit = HEARTS, .is_face_down = true};
+    board->tableaus[1].cards[1] = (Card){.rank = 1, .suit = CLUBS, .is_face_down = false};
+    board->tableaus[1].cards[2] = (Card){.rank = 2, .suit = CLUBS, .is_face_down = false};
+    // Tableau 2: King down to 3 of Clubs; tableau 3: King down to 4 of Hearts
+    for (int rank = 13; rank >= 3; rank--)
+        board->tableaus[2].cards[++board->tableaus[2].top] = (Card){.rank = (uint8_t)rank, .suit = CLUBS, .is_face_down = false};
+    for (int rank = 13; rank >= 4; rank--)
+        board->tableaus[3].cards[++board->tableaus[3].top] = (Card){.rank = (uint8_t)rank, .suit = HEARTS, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+
+    bool result = !is_safe_to_autoplay(board, board->tableaus[0].cards[0]) && autoplay_safe_cards(board, NULL) == 0;
+    static SolveResult solution;
+    result = result && solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) == SOLVE_WON;
+    free_board(board);
+    return result;
+}
+
+// Test 34: Solve a deal on a fresh table, and again on a small table reused by other deals (should search exactly the same positions)
+bool test_reused_table_matches_fresh_table()
+{
+    Board board;
+    static SolveResult fresh, reused;
+    TranspositionTable table;
+    if (!create_transposition_table(&table, 12))
+        return false;
+    initialize_board_from_seed(&board, 3);
+    solve_board(&board, SOLVE_FULL_INFORMATION, 20000, &table, &fresh);
+    bool result = true;
+    for (int round = 0; round < 2 && result; round++)
+    {
+        // Fill the table with other deals, the second time across a wrap of the generations
+        if (round == 1)
+            table.generation = TRANSPOSITION_GENERATION_MASK - 1;
+        for (uint64_t seed = 4; seed < 6; seed++)
+        {
+            Board other;
+            initialize_board_from_seed(&other, seed);
+            solve_board(&other, SOLVE_FULL_INFORMATION, 20000, &table, &reused);
+        }
+        solve_board(&board, SOLVE_FULL_INFORMATION, 20000, &table, &reused);
+        result = reused.status == fresh.status && reused.nodes == fresh.nodes && reused.num_moves == fresh.num_moves;
+    }
+    free_transposition_table(&table);
+    return result;
+}
+
+// Test 35: Solve a position where sending the King of Clubs up turns over the King of Hearts and strands the Queen of Hearts
+// (should be won with full information, lost by an honest search that commits to the turned card, and an honest search should still win the Test 17 position)
+bool test_honest_solver_commits_after_reveal()
+{
+    Board *board = create_board();
+    fill_foundation(board, HEARTS, 10);
+    fill_foundation(board, DIAMONDS, 13);
+    fill_foundation(board, CLUBS, 12);
+    fill_foundation(board, SPADES, 13);
+    // Tableau 0: Jack of Hearts under Queen of Hearts, which can only move onto the King of Clubs
+    board->tableaus[0].top = 1;
+    board->tableaus[0].cards[0] = (Card){.rank = 11, .suit = HEARTS, .is_face_down = false};
+    board->tableaus[0].cards[1] = (Card){.rank = 12, .suit = HEARTS, .is_face_down = false};
+    // Tableau 1: face-down King of Hearts under King of Clubs
+    board->tableaus[1].top = 1;
+    board->tableaus[1].cards[0] = (Card){.rank = 13, .suit = HEARTS, .is_face_down = true};
+    board->tableaus[1].cards[1] = (Card){.rank = 13, .suit = CLUBS, .is_face_down = false};
+    board->hash = compute_board_hash(board);
+    rebuild_card_locations(board);
+
+    // The foundation move is tried first; with full information the search backs out of it
+    static SolveResult solution;
+    bool result = solve_board(board, SOLVE_FULL_INFORMATION, 100000, NULL, &solution) == SOLVE_WON &&
+                  solve_board(board, SOLVE_HONEST, 100000, NULL, &solution) == SOLVE_LOST;
+    free_board(board);
+    board = create_board();
+    set_up_nearly_won_board(board);
+    result = result && solve_board(board, SOLVE_HONEST, 100000, NULL, &solution) == SOLVE_WON;
+    for (int i = 0; i < solution.num_moves && result; i++)
+        result = apply_move(board, solution.moves[i], NULL);
+    result = result && check_win_condition(board);
+    free_board(board);
+    return result;
+}
+
 void run_test(const char *name, TestFunc func)
 {
     bool passed = func();
@@ -252,5 +1185,29 @@ int main()
     run_test("Test9: Automatically turn face-down card after moving all face-up cards", test_auto_turn_facedown_card);
     run_test("Test10: Move group with only starting and target cards in sequence and alternate color", test_move_group_sequence_and_color_only);
     run_test("Test11: Move sequence starting with King to empty tableau", test_move_king_sequence_to_empty_tableau);
+    run_test("Test12: Pack and unpack board round trip", test_pack_unpack_round_trip);
+    run_test("Test13: Deal from seed is reproducible", test_deal_from_seed_is_reproducible);
+    run_test("Test14: Generate legal moves without changing the board", test_generate_moves);
+    run_test("Test15: Apply and undo a move that turns a card face-up", test_apply_and_undo_move_with_flip);
+    run_test("Test16: Incremental hash and card locations match full recomputation", test_incremental_state_matches_full_recomputation);
+    run_test("Test17: Solver finds a win and the moves win", test_solver_finds_win);
+    run_test("Test18: Solver proves a blocked position lost", test_solver_proves_loss);
+    run_test("Test19: Heuristic playouts win a nearly won position", test_playouts_from_nearly_won_board);
+    run_test("Test20: Board pool reuses boards and respects its limit", test_board_pool_reuse_and_limit);
+    run_test("Test21: Game record round trip and corruption check", test_record_write_and_replay);
+    run_test("Test22: Verify concatenated records with per-move status", test_verify_concatenated_records);
+    run_test("Test23: Deal database is built incrementally and looked up by seed", test_deal_database_build_and_lookup);
+    run_test("Test24: Hint engine suggests winning moves without changing the board", test_hint_suggests_winning_move_without_changing_board);
+    run_test("Test25: Bitboard acceptors match the placement rules", test_bitboard_matches_rules);
+    run_test("Test26: Auto-play sends only safe cards to the foundations", test_autoplay_moves_only_safe_cards);
+    run_test("Test27: Equivalent boards share a canonical form", test_equivalent_boards_share_canonical_form);
+    run_test("Test28: Dead positions are detected without search", test_dead_positions_are_detected);
+    run_test("Test29: Pile operations are counted per thread", test_operation_counters);
+    run_test("Test30: Multiboard lanes match single boards", test_multiboard_matches_single_boards);
+    run_test("Test31: Generated rule tables match rules.c", test_rule_tables_match_rules);
+    run_test("Test32: Engine protocol round trips and answers pipelined commands", test_engine_protocol);
+    run_test("Test33: Auto-play keeps a Two that an opposite-colour Ace must be carried onto", test_autoplay_keeps_two_needed_by_ace);
+    run_test("Test34: A reused transposition table searches like a fresh one", test_reused_table_matches_fresh_table);
+    run_test("Test35: Honest solver cannot take back a move that turned a card over", test_honest_solver_commits_after_reveal);
     return 0;
 }
@@ -0,0 +1,282 @@
+#include "../board.h"
+#include "../cards.h"
+#include "../constants.h"
+#include "../moves.h"
+#include "../multiboard.h"
+#include "../pile.h"
+#include "../record.h"
+#include "../rng.h"
+#include "../zobrist.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Differential tester for the move engine.
+ * Plays random move sequences on seeded deals through pile.c (the reference, as used by the game
+ * and yukon-verify), through moves.c (the make/unmake engine used by the solver) and through a lane
+ * of a multiboard.h batch, and compares the full board state after every step:
+ * legality, piles, face-down cards, hash and card locations.
+ * It also checks that undo_move restores the board exactly, and every few steps that generate_moves
+ * lists exactly the moves pile.c accepts.
+ * A mismatch is shrunk to a short move sequence that still shows it, and printed.
+ *
+ * Usage: test_differential [--games N] [--steps N] [--seed S]
+ */
+
+#define MAX_STEPS 10000
+#define ENUMERATE_EVERY 16 // Steps between full comparisons of generate_moves with pile.c
+
+/**
+ * Represents a random test case: a deal and the moves tried on it (legal or not).
+ */
+typedef struct
+{
+    uint64_t seed;
+    Move moves[MAX_STEPS];
+    int num_moves;
+} TestCase;
+
+/**
+ * Represents the first mismatch found while running a case.
+ */
+typedef struct
+{
+    int step;            // Index of the move after which the boards differed (-1 if they never did)
+    const char *problem; // What differed
+} Mismatch;
+
+/**
+ * Helper function to compare the full state of the reference board and the engine board.
+ * Returns NULL if they match, or what differs.
+ */
+static const char *compare_boards(const Board *reference, const Board *engine)
+{
+    if (reference->hand.size != 0 || engine->hand.size != 0)
+        return "cards left in hand";
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        const Tableau *a = &reference->tableaus[i], *b = &engine->tableaus[i];
+        if (a->top != b->top)
+            return "tableau sizes differ";
+        for (int j = 0; j <= a->top; j++)
+        {
+            if (a->cards[j].rank != b->cards[j].rank || a->cards[j].suit != b->cards[j].suit ||
+                a->cards[j].is_face_down != b->cards[j].is_face_down)
+                return "tableau cards differ";
+        }
+    }
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        const Foundation *a = &reference->foundations[i], *b = &engine->foundations[i];
+        if (a->top != b->top)
+            return "foundation sizes differ";
+        for (int j = 0; j <= a->top; j++)
+        {
+            if (!compare_cards(a->cards[j], b->cards[j]))
+                return "foundation cards differ";
+        }
+    }
+    if (reference->hash != engine->hash)
+        return "hashes differ";
+    if (reference->hash != compute_board_hash(reference))
+        return "reference hash is stale";
+    if (memcmp(reference->locations, engine->locations, sizeof(reference->locations)) != 0)
+        return "card locations differ";
+    return NULL;
+}
+
+/**
+ * Helper function to check that generate_moves lists exactly the moves pile.c accepts.
+ */
+static bool moves_match_piles(const Board *reference, const Board *engine)
+{
+    Move generated[MAX_MOVES];
+    int num_generated = generate_moves(engine, generated);
+    for (int i = 0; i < num_generated; i++)
+    {
+        Board copy = *reference;
+        if (play_move_through_piles(&copy, generated[i]) != MOVE_OK)
+            return false;
+    }
+    // Every move pile.c accepts must be generated, so count them
+    int num_accepted = 0;
+    for (int from = 0; from < NUM_TABLEAUS; from++)
+    {
+        for (int count = 1; count <= reference->tableaus[from].top + 1; count++)
+        {
+            for (int to = 0; to < NUM_TABLEAUS; to++)
+            {
+                Board copy = *reference;
+                Move move = {MOVE_TO_TABLEAU, (uint8_t)from, (uint8_t)to, (uint8_t)count};
+                num_accepted += play_move_through_piles(&copy, move) == MOVE_OK;
+            }
+        }
+        for (int to = 0; to < NUM_SUITS; to++)
+        {
+            Board copy = *reference;
+            Move move = {MOVE_TO_FOUNDATION, (uint8_t)from, (uint8_t)to, 1};
+            num_accepted += play_move_through_piles(&copy, move) == MOVE_OK;
+        }
+    }
+    return num_accepted == num_generated;
+}
+
+/**
+ * Replays a case through both implementations and reports the first mismatch.
+ * With enumerate_all, generate_moves is compared with pile.c after every step.
+ */
+static Mismatch run_case(const TestCase *test_case, bool enumerate_all)
+{
+    static Board reference, engine, lane;
+    static MultiBoard batch;
+    static Move lane_moves[MULTIBOARD_MAX_LANES];
+    initialize_board_from_seed(&reference, test_case->seed);
+    engine = reference;
+    init_multiboard(&batch, 1);
+    load_lane(&batch, 0, &reference);
+    for (int i = 0; i < test_case->num_moves; i++)
+    {
+        Move move = test_case->moves[i];
+        Board before = engine;
+        bool accepted = play_move_through_piles(&reference, move) == MOVE_OK;
+        UndoEntry undo;
+        if (accepted != apply_move(&engine, move, &undo))
+            return (Mismatch){i, "pile.c and is_legal_move disagree on legality"};
+        lane_moves[0] = move;
+        LaneMask flipped;
+        if (accepted != (apply_moves(&batch, lane_moves, 1, &flipped) == 1) || (accepted && undo.flipped != (flipped == 1)))
+            return (Mismatch){i, "pile.c and the multiboard disagree on legality or flips"};
+        if (accepted)
+        {
+            Board undone = engine;
+            undo_move(&undone, &undo);
+            if (compare_boards(&before, &undone) != NULL)
+                return (Mismatch){i, "undo_move does not restore the board"};
+        }
+        const char *problem = compare_boards(&reference, &engine);
+        if (problem != NULL)
+            return (Mismatch){i, problem};
+        store_lane(&batch, 0, &lane);
+        if (compare_boards(&reference, &lane) != NULL)
+            return (Mismatch){i, "the multiboard lane differs from pile.c"};
+        if ((enumerate_all || i % ENUMERATE_EVERY == 0) && !moves_match_piles(&reference, &engine))
+            return (Mismatch){i, "generate_moves differs from the moves pile.c accepts"};
+    }
+    return (Mismatch){-1, NULL};
+}
+
+/**
+ * Fills a case with random moves: mostly legal ones, so games get deep,
+ * and some with random fields, which are mostly illegal.
+ */
+static void make_random_case(TestCase *test_case, uint64_t seed, int num_steps, Rng *rng)
+{
+    Board board;
+    initialize_board_from_seed(&board, seed);
+    test_case->seed = seed;
+    test_case->num_moves = num_steps;
+    for (int i = 0; i < num_steps; i++)
+    {
+        Move moves[MAX_MOVES];
+        int num_moves = generate_moves(&board, moves);
+        Move move;
+        if (num_moves > 0 && rng_below(rng, 4) != 0)
+        {
+            move = moves[rng_below(rng, (uint32_t)num_moves)];
+        }
+        else
+        {
+            // Indices one past the end are included to exercise the range checks
+            move.type = (uint8_t)rng_below(rng, 2);
+            move.from = (uint8_t)rng_below(rng, NUM_TABLEAUS + 1);
+            move.to = (uint8_t)rng_below(rng, (move.type == MOVE_TO_TABLEAU ? NUM_TABLEAUS : NUM_SUITS) + 1);
+            move.count = (uint8_t)rng_below(rng, 8);
+        }
+        test_case->moves[i] = move;
+        apply_move(&board, move, NULL);
+    }
+}
+
+/**
+ * Shrinks a failing case: drops every move after the mismatch, then keeps removing
+ * single moves for as long as some mismatch remains.
+ */
+static Mismatch shrink_case(TestCase *test_case, Mismatch mismatch)
+{
+    test_case->num_moves = mismatch.step + 1;
+    bool shrunk = true;
+    while (shrunk)
+    {
+        shrunk = false;
+        for (int i = test_case->num_moves - 1; i >= 0; i--)
+        {
+            TestCase candidate = *test_case;
+            memmove(&candidate.moves[i], &candidate.moves[i + 1], sizeof(Move) * (size_t)(candidate.num_moves - i - 1));
+            candidate.num_moves--;
+            Mismatch result = run_case(&candidate, true);
+            if (result.step >= 0)
+            {
+                *test_case = candidate;
+                test_case->num_moves = result.step + 1;
+                mismatch = result;
+                shrunk = true;
+                break;
+            }
+        }
+    }
+    return mismatch;
+}
+
+/**
+ * Helper function to print a failing case so it can be turned into a test.
+ */
+static void print_case(const TestCase *test_case, Mismatch mismatch)
+{
+    printf("Mismatch on seed %llu after move %d: %s\n", (unsigned long long)test_case->seed, mismatch.step + 1,
+           mismatch.problem);
+    for (int i = 0; i < test_case->num_moves; i++)
+    {
+        Move move = test_case->moves[i];
+        printf("  %d: %s from %d to %d count %d\n", i + 1, move.type == MOVE_TO_TABLEAU ? "tableau" : "foundation",
+               move.from, move.to, move.count);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int num_games = 10000, num_steps = 100;
+    uint64_t seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--games") == 0)
+            num_games = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--steps") == 0)
+            num_steps = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0)
+            seed = strtoull(argv[i + 1], NULL, 10);
+    }
+    if (num_steps < 1)
+        num_steps = 1;
+    if (num_steps > MAX_STEPS)
+        num_steps = MAX_STEPS;
+
+    static TestCase test_case;
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (int game = 0; game < num_games; game++)
+    {
+        make_random_case(&test_case, rng_next(&rng), num_steps, &rng);
+        Mismatch mismatch = run_case(&test_case, false);
+        if (mismatch.step >= 0)
+        {
+            mismatch = shrink_case(&test_case, mismatch);
+            print_case(&test_case, mismatch);
+            return EXIT_FAILURE;
+        }
+    }
+    printf("%d games of %d steps: pile.c, moves.c and the multiboard agree\n", num_games, num_steps);
+    return 0;
+}
@@ -4,9 +4,14 @@
 #include "../win.h"
 #include "../rules.h"
 #include "../constants.h"
+#include "../moves.h"
+#include "../hint.h"
+#include "../autoplay.h"
 #include <stdio.h>
 #include <string.h>
 
+#define HINT_BUDGET_US 5000 // Time the hint engine may think for
+
 void print_card(const Card *card)
 {
     const char *suits_ascii[] = {"♥", "♦", "♣", "♠"};
@@ -53,13 +58,36 @@ void print_foundations(const Board *board)
     }
 }
 
+// Checks the typed numbers of a move before they are narrowed into a Move, so out-of-range input cannot wrap
+bool is_move_in_range(int from, int num, int to, int num_targets)
+{
+    return from >= 1 && from <= NUM_TABLEAUS && num >= 1 && num <= TABLEAU_MAX_SIZE && to >= 1 && to <= num_targets;
+}
+
+// Sends safe cards to the foundations after a move, keeping them on the undo stack so one undo takes back both
+void autoplay_after_move(Board *board, UndoStack *undo_stack)
+{
+    UndoEntry autoplayed[MAX_AUTOPLAY_MOVES];
+    int num_autoplayed = autoplay_safe_cards(board, autoplayed);
+    for (int i = 0; i < num_autoplayed; i++)
+        push_undo_entry(undo_stack, &autoplayed[i]);
+    if (num_autoplayed > 0)
+        printf("Auto-played %d card%s to the foundations.\n", num_autoplayed, num_autoplayed == 1 ? "" : "s");
+}
+
 int main()
 {
     Board *board = create_board();
     initialize_board(board);
+    UndoStack undo_stack;
+    init_undo_stack(&undo_stack);
+    UndoEntry undo;
     char command[64];
     int t_from, t_to, num, f_to;
+    bool autoplay = true; // Whether safe cards go to the foundations on their own
     printf("Welcome to Yukon Solitaire!\nType 'help' for command info.\n\n");
+    if (autoplay)
+        autoplay_after_move(board, &undo_stack);
     print_tableaus(board);
     print_foundations(board);
     while (1)
@@ -69,18 +97,56 @@ int main()
             break;
         if (sscanf(command, "move %d %d %d", &t_from, &num, &t_to) == 3)
         {
-            pick_up_cards(board, t_from - 1, num);
-            place_cards_on_tableau(board, t_to - 1);
+            Move move = {MOVE_TO_TABLEAU, (uint8_t)(t_from - 1), (uint8_t)(t_to - 1), (uint8_t)num};
+            if (is_move_in_range(t_from, num, t_to, NUM_TABLEAUS) && apply_move(board, move, &undo))
+            {
+                push_undo_entry(&undo_stack, &undo);
+                if (autoplay)
+                    autoplay_after_move(board, &undo_stack);
+            }
+            else
+                printf("Illegal move.\n");
             print_tableaus(board);
             print_foundations(board);
         }
         else if (sscanf(command, "movef %d %d %d", &t_from, &num, &f_to) == 3)
         {
-            pick_up_cards(board, t_from - 1, num);
-            place_card_on_foundation(board, f_to - 1);
+            Move move = {MOVE_TO_FOUNDATION, (uint8_t)(t_from - 1), (uint8_t)(f_to - 1), (uint8_t)num};
+            if (is_move_in_range(t_from, num, f_to, NUM_SUITS) && apply_move(board, move, &undo))
+            {
+                push_undo_entry(&undo_stack, &undo);
+                if (autoplay)
+                    autoplay_after_move(board, &undo_stack);
+            }
+            else
+                printf("Illegal move.\n");
             print_tableaus(board);
             print_foundations(board);
         }
+        else if (strncmp(command, "undo", 4) == 0)
+        {
+            if (undo_last_move(&undo_stack, board) == 0)
+                printf("Nothing to undo.\n");
+            print_tableaus(board);
+            print_foundations(board);
+        }
+        else if (strncmp(command, "auto", 4) == 0)
+        {
+            autoplay = !autoplay;
+            printf("Auto-play is %s.\n", autoplay ? "on" : "off");
+            if (autoplay)
+                autoplay_after_move(board, &undo_stack);
+        }
+        else if (strncmp(command, "hint", 4) == 0)
+        {
+            Move move;
+            if (!suggest_move(board, HINT_BUDGET_US, &move))
+                printf("No useful move.\n");
+            else if (move.type == MOVE_TO_FOUNDATION)
+                printf("Try: movef %d %d %d\n", move.from + 1, move.count, move.to + 1);
+            else
+                printf("Try: move %d %d %d\n", move.from + 1, move.count, move.to + 1);
+        }
         else if (strncmp(command, "print", 5) == 0)
         {
             print_tableaus(board);
@@ -91,6 +157,9 @@ int main()
             printf("Commands:\n");
             printf("  move <from> <num> <to>        - Move <num> cards from tableau <from> to tableau <to>\n");
             printf("  movef <from> <num> <foundation> - Move <num> cards from tableau <from> to foundation <foundation>\n");
+            printf("  undo                          - Take back the last move and the cards auto-played after it\n");
+            printf("  hint                          - Suggest a move\n");
+            printf("  auto                          - Turn sending safe cards to the foundations on or off\n");
             printf("  print                         - Print the board\n");
             printf("  quit                          - Exit the game\n");
             printf("  help                          - Show this help message\n");
@@ -101,7 +170,7 @@ int main()
         }
         else
         {
-            printf("Unknown command. Try: move <from> <num> <to>, movef <from> <num> <foundation>, print, quit\n");
+            printf("Unknown command. Try: move <from> <num> <to>, movef <from> <num> <foundation>, undo, hint, auto, print, quit\n");
         }
         if (check_win_condition(board))
         {
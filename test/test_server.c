@@ -0,0 +1,132 @@
+#include "../board.h"
+#include "../protocol.h"
+#include "../sessions.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Tests for the session host behind yukon-server.
+ * sessions.c uses epoll, so these tests only build on Linux; the portable tests are in test_circumstances.c.
+ */
+
+#define CHECKMARK "\xE2\x9C\x94"
+#define CROSS "\xE2\x9C\x98"
+
+typedef bool (*TestFunc)();
+
+// Helper function to send requests on a served connection and collect the expected number of response lines
+bool exchange_with_server(Server *server, int fd, const char *requests, int num_lines, char *responses, size_t size)
+{
+    if (write(fd, requests, strlen(requests)) != (ssize_t)strlen(requests))
+        return false;
+    size_t length = 0;
+    int lines = 0;
+    for (int tries = 0; tries < 100 && lines < num_lines; tries++)
+    {
+        serve_events(server, 10);
+        ssize_t received = recv(fd, responses + length, size - 1 - length, MSG_DONTWAIT);
+        for (ssize_t i = 0; i < received; i++)
+            lines += responses[length + (size_t)i] == '\n';
+        if (received > 0)
+            length += (size_t)received;
+    }
+    responses[length] = '\0';
+    return lines == num_lines;
+}
+
+// Test 1: Serve two connections (should keep each one's sessions private, end them on quit or disconnect, and cap hints)
+bool test_server_sessions()
+{
+    static Server server;
+    int a[2], b[2];
+    if (!init_server(&server, 16))
+        return false;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, a) != 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, b) != 0)
+    {
+        destroy_server(&server);
+        return false;
+    }
+    bool result = add_connection(&server, a[1]) && add_connection(&server, b[1]);
+    char responses[1024], request[64];
+    unsigned a_id = 0, b_id = 0;
+    result = result && exchange_with_server(&server, a[0], "create 5\n", 1, responses, sizeof(responses)) &&
+             sscanf(responses, "session %u", &a_id) == 1;
+    result = result && exchange_with_server(&server, b[0], "create 6\n", 1, responses, sizeof(responses)) &&
+             sscanf(responses, "session %u", &b_id) == 1 && a_id != b_id;
+    // B cannot see A's session, only its own
+    snprintf(request, sizeof(request), "%u get\n%u get\n", a_id, b_id);
+    result = result && exchange_with_server(&server, b[0], request, 2, responses, sizeof(responses)) &&
+             strncmp(responses, "error no_session\nposition ", 26) == 0;
+    // A two-second hint is cut down to the server's limit
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    snprintf(request, sizeof(request), "%u hint 2000000\n", a_id);
+    result = result && exchange_with_server(&server, a[0], request, 1, responses, sizeof(responses)) &&
+             strncmp(responses, "hint ", 5) == 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    result = result && (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec) < 500000000L;
+    // quit ends the session
+    snprintf(request, sizeof(request), "%u quit\n%u get\n", a_id, a_id);
+    result = result && exchange_with_server(&server, a[0], request, 2, responses, sizeof(responses)) &&
+             strcmp(responses, "ok\nerror no_session\n") == 0;
+    // Closing B ends its session, so its slot is the next one handed out
+    close(b[0]);
+    for (int i = 0; i < 3; i++)
+        serve_events(&server, 10);
+    unsigned new_id = 0;
+    result = result && exchange_with_server(&server, a[0], "create 7\n", 1, responses, sizeof(responses)) &&
+             sscanf(responses, "session %u", &new_id) == 1 && new_id == b_id;
+    destroy_server(&server);
+    close(a[0]);
+    return result;
+}
+
+// Helper function to read the resident memory of this process in bytes (0 if unknown)
+size_t get_resident_bytes()
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    unsigned long size = 0, resident = 0;
+    if (file == NULL)
+        return 0;
+    if (fscanf(file, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+    fclose(file);
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// Test 2: Set up a server for the default number of sessions and open one (should not touch the memory of unused session slots)
+bool test_server_memory_grows_with_use()
+{
+    static Server server;
+    size_t before = get_resident_bytes();
+    if (!init_server(&server, DEFAULT_MAX_SESSIONS))
+        return false;
+    int fds[2];
+    bool result = socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0 && add_connection(&server, fds[1]);
+    char responses[256];
+    result = result && exchange_with_server(&server, fds[0], "create 1\n0 get\n", 2, responses, sizeof(responses)) &&
+             strncmp(responses, "session 0\nposition ", 19) == 0;
+    // The whole table is DEFAULT_MAX_SESSIONS * sizeof(Session), about 100 MB
+    size_t grown = get_resident_bytes() - before;
+    result = result && before > 0 && grown < (size_t)DEFAULT_MAX_SESSIONS * sizeof(Session) / 16;
+    destroy_server(&server);
+    close(fds[0]);
+    return result;
+}
+
+void run_test(const char *name, TestFunc func)
+{
+    bool passed = func();
+    printf("%s: %s %s\n", name, passed ? CHECKMARK : CROSS, passed ? "" : "(failed)");
+}
+
+int main()
+{
+    run_test("Test1: Server keeps sessions per connection and caps hint budgets", test_server_sessions);
+    run_test("Test2: Server memory grows with the sessions in use, not the limit", test_server_memory_grows_with_use);
+    return 0;
+}
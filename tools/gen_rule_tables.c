@@ -0,0 +1,77 @@
+#include "../cards.h"
+#include "../constants.h"
+#include "../rules.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file gen_rule_tables.c
+ * Generates rule_tables.c from the rules in rules.c.
+ * Every card is asked about every possible top card (and the "null" card of an empty pile),
+ * and the answers are written as one 52-bit card mask per top card.
+ *
+ * Usage: gen_rule_tables > rule_tables.c
+ */
+
+/**
+ * Helper function to get the card with the given index (0 to 51), or the "null" card for DECK_SIZE.
+ */
+static Card get_card_from_index(int index)
+{
+    if (index == DECK_SIZE)
+        return (Card){0};
+    return (Card){.rank = (uint8_t)(index % FOUNDATION_SIZE + 1), .suit = (uint8_t)(index / FOUNDATION_SIZE)};
+}
+
+/**
+ * Helper function to print a table row with a comment naming its top card.
+ */
+static void print_row(uint64_t mask, int row, const char *indent)
+{
+    const char *suits[] = {"Hearts", "Diamonds", "Clubs", "Spades"};
+    if (row == DECK_SIZE)
+        printf("%s0x%013llxULL, // Empty pile\n", indent, (unsigned long long)mask);
+    else
+        printf("%s0x%013llxULL, // Rank %d of %s\n", indent, (unsigned long long)mask, row % FOUNDATION_SIZE + 1,
+               suits[row / FOUNDATION_SIZE]);
+}
+
+int main()
+{
+    printf("// Generated by tools/gen_rule_tables.c from rules.c. Do not edit; regenerate instead (see the README).\n");
+    printf("#include \"rule_tables.h\"\n");
+    printf("#include <stdint.h>\n\n");
+    printf("/**\n * @file rule_tables.c\n * Holds the generated placement tables declared in rule_tables.h.\n */\n\n");
+
+    printf("const uint64_t tableau_rule_table[RULE_TABLE_ROWS] = {\n");
+    for (int row = 0; row <= DECK_SIZE; row++)
+    {
+        uint64_t mask = 0;
+        for (int i = 0; i < DECK_SIZE; i++)
+        {
+            if (can_place_on_tableau(get_card_from_index(i), get_card_from_index(row)))
+                mask |= 1ULL << i;
+        }
+        print_row(mask, row, "    ");
+    }
+    printf("};\n\n");
+
+    printf("const uint64_t foundation_rule_table[NUM_SUITS][RULE_TABLE_ROWS] = {\n");
+    for (int suit = 0; suit < NUM_SUITS; suit++)
+    {
+        printf("    {\n");
+        for (int row = 0; row <= DECK_SIZE; row++)
+        {
+            uint64_t mask = 0;
+            for (int i = 0; i < DECK_SIZE; i++)
+            {
+                if (can_place_on_foundation(get_card_from_index(i), get_card_from_index(row), (Suit)suit))
+                    mask |= 1ULL << i;
+            }
+            print_row(mask, row, "        ");
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "transposition.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/**
+ * @file transposition.c
+ * Implements the lock-free transposition table.
+ */
+
+/**
+ * Allocates a table with 2^log2_entries slots.
+ * Returns false if the memory cannot be allocated.
+ */
+bool create_transposition_table(TranspositionTable *table, int log2_entries)
+{
+    if (log2_entries < 2)
+        log2_entries = 2;
+    size_t num_entries = (size_t)1 << log2_entries;
+    // calloc leaves every slot empty (0)
+    table->entries = calloc(num_entries, sizeof(uint64_t));
+    if (table->entries == NULL)
+        return false;
+    table->mask = num_entries / TRANSPOSITION_BUCKET_SIZE - 1;
+    table->generation = 1;
+    return true;
+}
+
+/**
+ * Frees the memory used by a table.
+ */
+void free_transposition_table(TranspositionTable *table)
+{
+    free((void *)table->entries);
+    table->entries = NULL;
+}
+
+/**
+ * Empties every slot of a table.
+ * Must not run while other threads use the table.
+ * Searches do not need this (see start_transposition_search).
+ */
+void clear_transposition_table(TranspositionTable *table)
+{
+    size_t num_entries = (table->mask + 1) * TRANSPOSITION_BUCKET_SIZE;
+    for (size_t i = 0; i < num_entries; i++)
+    {
+        atomic_store_explicit(&table->entries[i], 0, memory_order_relaxed);
+    }
+}
+
+/**
+ * Adds a hash to the table for the current search.
+ * Returns true if the hash was already added in this search, false if it was newly added.
+ */
+bool transposition_table_insert(TranspositionTable *table, uint64_t hash)
+{
+    // The generation replaces the low bits of the hash, which mostly pick the bucket anyway
+    uint64_t tagged = (hash & ~TRANSPOSITION_GENERATION_MASK) | table->generation;
+    _Atomic uint64_t *bucket = &table->entries[(hash & table->mask) * TRANSPOSITION_BUCKET_SIZE];
+    for (int i = 0; i < TRANSPOSITION_BUCKET_SIZE; i++)
+    {
+        uint64_t entry = atomic_load_explicit(&bucket[i], memory_order_relaxed);
+        if (entry == tagged)
+            return true;
+        if ((entry & TRANSPOSITION_GENERATION_MASK) != table->generation)
+        {
+            // Claim the slot left empty for this search; if another thread got there first, keep looking
+            if (atomic_compare_exchange_strong_explicit(&bucket[i], &entry, tagged, memory_order_relaxed, memory_order_relaxed))
+                return false;
+            if (entry == tagged)
+                return true;
+        }
+    }
+    // Bucket is full: overwrite a slot picked by the high bits of the hash
+    atomic_store_explicit(&bucket[(hash >> 32) % TRANSPOSITION_BUCKET_SIZE], tagged, memory_order_relaxed);
+    return false;
+}
+
+/**
+ * Starts a new search on a table: entries stored before it are no longer seen.
+ * Instead of sweeping the table, this moves to the next generation; the table is only
+ * really cleared when the generations wrap around, once every 65535 searches.
+ * Must not run while other threads use the table.
+ */
+void start_transposition_search(TranspositionTable *table)
+{
+    if (table->generation == TRANSPOSITION_GENERATION_MASK)
+    {
+        clear_transposition_table(table);
+        table->generation = 0;
+    }
+    table->generation++;
+}
@@ -0,0 +1,46 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file transposition.h
+ * Defines a fixed-size, lock-free transposition table of visited board hashes.
+ */
+
+/**
+ * Number of entries in a bucket. A bucket is 32 bytes, so it never spans cache lines.
+ */
+#define TRANSPOSITION_BUCKET_SIZE 4
+
+/**
+ * Low bits of an entry that hold the generation of the search that stored it
+ * (the rest holds the high bits of the hash).
+ */
+#define TRANSPOSITION_GENERATION_MASK 0xFFFFULL
+
+/**
+ * Represents a set of board hashes with a fixed number of slots.
+ * Every slot is a single atomic 64-bit word, so many threads can share
+ * a table without locks. When a bucket is full an old entry is overwritten,
+ * so the table may forget positions but never reports one it has not seen.
+ * Each search stores its entries tagged with a new generation, and entries of any other
+ * generation count as empty, so a search sees the table as if it had just been cleared.
+ */
+typedef struct
+{
+    _Atomic uint64_t *entries; // Slots holding tagged hashes (0 marks a never used slot)
+    size_t mask;               // Number of buckets minus one
+    uint64_t generation;       // Generation of the current search (1 to TRANSPOSITION_GENERATION_MASK)
+} TranspositionTable;
+
+bool create_transposition_table(TranspositionTable *table, int log2_entries);
+void free_transposition_table(TranspositionTable *table);
+void clear_transposition_table(TranspositionTable *table);
+bool transposition_table_insert(TranspositionTable *table, uint64_t hash);
+void start_transposition_search(TranspositionTable *table);
+
+#endif // TRANSPOSITION_H
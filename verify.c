@@ -0,0 +1,287 @@
+/**
+ * @file verify.c
+ * Entry point for yukon-verify, which checks a file of submitted solutions on all cores.
+ *
+ * Usage: yukon-verify <submissions_file> <output_file> [--threads N] [--counters counters_file]
+ *
+ * The submissions file is a concatenation of game records (see record.h).
+ * Every record is dealt from its seed and replayed through pile.c,
+ * the same code that plays the interactive game, and accepted only if it ends in a win.
+ * The results file has one line per submission: index,seed,result,moves,move_status
+ * where result is won, not_won, illegal_move or bad_record, moves is the number of moves
+ * applied and move_status names the MoveStatus of the first rejected move.
+ * With --counters, the pile operation counters of all workers (see counters.h) are added up
+ * and written to counters_file as JSON.
+ */
+
+#include "board.h"
+#include "counters.h"
+#include "pile.h"
+#include "record.h"
+#include "win.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define VERIFY_CHUNK_SIZE 256 // Submissions taken by a worker at a time
+
+/**
+ * Represents the verdict on one submission.
+ */
+typedef enum
+{
+    VERDICT_WON,
+    VERDICT_NOT_WON,
+    VERDICT_ILLEGAL_MOVE,
+    VERDICT_BAD_RECORD
+} Verdict;
+
+/**
+ * Represents one submission: where its record is in the file and what was found.
+ */
+typedef struct
+{
+    size_t offset;
+    size_t size; // 0 if the record could not be framed
+    Verdict verdict;
+    ReplayResult replay;
+} Submission;
+
+/**
+ * Holds the submissions and shared state of a verification run.
+ */
+typedef struct
+{
+    uint8_t *bytes;
+    size_t size;
+    Submission *submissions;
+    size_t count;
+    _Atomic size_t next; // Index of the next chunk of submissions to verify
+} Verification;
+
+static Verification verification;
+
+/**
+ * Helper function to read a monotonic clock in microseconds.
+ */
+static uint64_t now_us()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+/**
+ * Replays one submission and decides its verdict.
+ */
+static void verify_submission(Submission *submission, Board *board)
+{
+    if (submission->size == 0)
+    {
+        memset(&submission->replay, 0, sizeof(submission->replay));
+        submission->replay.status = REPLAY_BAD_RECORD;
+        submission->verdict = VERDICT_BAD_RECORD;
+        return;
+    }
+    ReplayStatus status = replay_record_buffer(verification.bytes + submission->offset, submission->size,
+                                               board, &submission->replay);
+    if (status == REPLAY_BAD_RECORD)
+        submission->verdict = VERDICT_BAD_RECORD;
+    else if (status == REPLAY_ILLEGAL_MOVE)
+        submission->verdict = VERDICT_ILLEGAL_MOVE;
+    else
+        submission->verdict = check_win_condition(board) ? VERDICT_WON : VERDICT_NOT_WON;
+}
+
+/**
+ * Thread function: verifies chunks of submissions until none are left.
+ * Submissions are independent and cheap, so a shared counter spreads them well enough.
+ * arg points to where the worker's operation counters are copied when it is done.
+ */
+static void *run_worker(void *arg)
+{
+    Board board;
+    while (true)
+    {
+        size_t first = atomic_fetch_add(&verification.next, VERIFY_CHUNK_SIZE);
+        if (first >= verification.count)
+            break;
+        size_t last = first + VERIFY_CHUNK_SIZE;
+        if (last > verification.count)
+            last = verification.count;
+        for (size_t i = first; i < last; i++)
+        {
+            verify_submission(&verification.submissions[i], &board);
+        }
+    }
+    get_thread_counters((OperationCounters *)arg);
+    return NULL;
+}
+
+/**
+ * Splits the submissions file into records.
+ * A submission that cannot be framed is kept as a bad record and ends the split,
+ * since the start of the next record cannot be found reliably.
+ */
+static bool split_submissions()
+{
+    size_t capacity = 1024;
+    verification.submissions = malloc(sizeof(Submission) * capacity);
+    if (verification.submissions == NULL)
+        return false;
+    size_t offset = 0;
+    while (offset < verification.size)
+    {
+        if (verification.count == capacity)
+        {
+            capacity *= 2;
+            Submission *grown = realloc(verification.submissions, sizeof(Submission) * capacity);
+            if (grown == NULL)
+                return false;
+            verification.submissions = grown;
+        }
+        Submission *submission = &verification.submissions[verification.count++];
+        submission->offset = offset;
+        submission->size = get_record_size(verification.bytes + offset, verification.size - offset);
+        if (submission->size == 0)
+            break;
+        offset += submission->size;
+    }
+    return true;
+}
+
+/**
+ * Helper function to read a whole file into memory.
+ */
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *bytes = malloc(length > 0 ? (size_t)length : 1);
+    if (length < 0 || bytes == NULL || fread(bytes, 1, (size_t)length, file) != (size_t)length)
+    {
+        free(bytes);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *size = (size_t)length;
+    return bytes;
+}
+
+/**
+ * Helper function to print usage information.
+ */
+static void print_usage()
+{
+    fprintf(stderr, "Usage: yukon-verify <submissions_file> <output_file> [--threads N] [--counters counters_file]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return EXIT_FAILURE;
+    }
+    const char *input_path = argv[1];
+    const char *output_path = argv[2];
+    const char *counters_path = NULL;
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            num_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--counters") == 0 && i + 1 < argc)
+            counters_path = argv[++i];
+        else
+        {
+            print_usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_threads < 1)
+        num_threads = 1;
+
+    verification.bytes = read_file(input_path, &verification.size);
+    if (verification.bytes == NULL)
+    {
+        fprintf(stderr, "Error: Unable to read %s.\n", input_path);
+        return EXIT_FAILURE;
+    }
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)num_threads);
+    OperationCounters *counters = calloc((size_t)num_threads, sizeof(OperationCounters));
+    if (threads == NULL || counters == NULL || !split_submissions())
+    {
+        fprintf(stderr, "Error: Unable to allocate memory for verification.\n");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t start = now_us();
+    atomic_init(&verification.next, 0);
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, run_worker, &counters[i]);
+    }
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    uint64_t elapsed_us = now_us() - start;
+
+    // Write the results in submission order
+    FILE *output = fopen(output_path, "w");
+    if (output == NULL)
+    {
+        fprintf(stderr, "Error: Unable to open %s for writing.\n", output_path);
+        return EXIT_FAILURE;
+    }
+    const char *verdict_names[] = {"won", "not_won", "illegal_move", "bad_record"};
+    size_t totals[4] = {0};
+    fprintf(output, "index,seed,result,moves,move_status\n");
+    for (size_t i = 0; i < verification.count; i++)
+    {
+        Submission *submission = &verification.submissions[i];
+        totals[submission->verdict]++;
+        fprintf(output, "%zu,%llu,%s,%u,%s\n", i, (unsigned long long)submission->replay.seed,
+                verdict_names[submission->verdict], submission->replay.num_moves,
+                get_move_status_name(submission->replay.move_status));
+    }
+    fclose(output);
+
+    if (counters_path != NULL)
+    {
+        OperationCounters total = {0};
+        for (int i = 0; i < num_threads; i++)
+        {
+            add_counters(&total, &counters[i]);
+        }
+        FILE *counters_file = fopen(counters_path, "w");
+        if (counters_file == NULL)
+        {
+            fprintf(stderr, "Error: Unable to open %s for writing.\n", counters_path);
+            return EXIT_FAILURE;
+        }
+        write_counters_json(counters_file, &total);
+        fclose(counters_file);
+    }
+
+    fprintf(stderr, "%zu submissions on %d threads in %.3f s (%.0f submissions/s): %zu won, %zu not won, %zu illegal, %zu bad\n",
+            verification.count, num_threads, elapsed_us / 1e6, verification.count / (elapsed_us / 1e6 + 1e-9),
+            totals[VERDICT_WON], totals[VERDICT_NOT_WON], totals[VERDICT_ILLEGAL_MOVE], totals[VERDICT_BAD_RECORD]);
+    free(verification.submissions);
+    free(verification.bytes);
+    free(counters);
+    free(threads);
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "win.h"
 #include "board.h"
+#include "counters.h"
 
 /**
  * @file win.c
@@ -7,10 +8,13 @@
  */
 bool check_win_condition(Board *board)
 {
-    for (int i = 0; i < NUM_SUITS; i++)
+    uint64_t start = start_operation();
+    bool won = true;
+    for (int i = 0; i < NUM_SUITS && won; i++)
     {
-        if (board->foundations[i].top != 12) // Each foundation should have
-            return false;                    // 13 cards (index 0 to 12)
+        won = board->foundations[i].top == 12; // Each foundation should have 13 cards (index 0 to 12)
     }
-    return true; // If all foundations are complete the game is won
+    thread_counters.wins += won; // If all foundations are complete the game is won
+    finish_operation(OPERATION_WIN_CHECK, MOVE_OK, start);
+    return won;
 }
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "zobrist.h"
+#include "board.h"
+#include "constants.h"
+
+/**
+ * @file zobrist.c
+ * Implements full recomputation of a board's Zobrist hash.
+ */
+
+/**
+ * Helper function to hash all the cards in one pile.
+ */
+static uint64_t hash_pile(const Card *cards, int size, int base)
+{
+    uint64_t hash = 0;
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= get_zobrist_key(cards[i], get_zobrist_location(cards, i, base));
+        if (cards[i].is_face_down)
+            hash ^= get_zobrist_key(cards[i], ZOBRIST_FACE_DOWN);
+    }
+    return hash;
+}
+
+/**
+ * Computes the Zobrist hash of a board from scratch.
+ * The result always equals the board's incrementally updated hash field.
+ */
+uint64_t compute_board_hash(const Board *board)
+{
+    uint64_t hash = 0;
+    for (int i = 0; i < NUM_TABLEAUS; i++)
+    {
+        hash ^= hash_pile(board->tableaus[i].cards, board->tableaus[i].top + 1, ZOBRIST_TABLEAU_BOTTOM);
+    }
+    for (int i = 0; i < NUM_SUITS; i++)
+    {
+        hash ^= hash_pile(board->foundations[i].cards, board->foundations[i].top + 1, ZOBRIST_FOUNDATION_BASE + i);
+    }
+    hash ^= hash_pile(board->hand.cards, board->hand.size, ZOBRIST_HAND_BASE);
+    return hash;
+}
@@ -0,0 +1,54 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "board.h"
+#include "cards.h"
+#include "constants.h"
+#include <stdint.h>
+
+/**
+ * @file zobrist.h
+ * Defines the Zobrist keys used to hash board positions.
+ *
+ * A position is described by what every card rests on: another card,
+ * the bottom of a tableau, the bottom of a foundation or the bottom of the hand,
+ * plus whether the card is face-down. Moving a group of cards only changes what
+ * the bottom card of the group rests on, so every move updates the hash
+ * with a couple of XORs no matter how many cards it moves.
+ *
+ * All tableau bottoms share one location, so positions that only differ in the order
+ * of their tableaus (including which tableaus are empty) hash the same.
+ * Such positions are equivalent for every search, so they share transposition table entries.
+ */
+
+// Locations a card can rest on (0 to 51 are the other cards)
+#define ZOBRIST_TABLEAU_BOTTOM DECK_SIZE                               // Bottom of any tableau
+#define ZOBRIST_FOUNDATION_BASE (ZOBRIST_TABLEAU_BOTTOM + 1)           // Bottom of foundation i is ZOBRIST_FOUNDATION_BASE + i
+#define ZOBRIST_HAND_BASE (ZOBRIST_FOUNDATION_BASE + NUM_SUITS)        // Bottom of the hand
+#define ZOBRIST_FACE_DOWN (ZOBRIST_HAND_BASE + 1)                      // Key used for a card being face-down
+
+/**
+ * Returns the Zobrist key for a card resting on a location (or for ZOBRIST_FACE_DOWN).
+ * Keys are computed from a fixed mixing function rather than a table, so they are
+ * the same in every process and need no initialization.
+ */
+static inline uint64_t get_zobrist_key(Card card, int location)
+{
+    uint64_t z = (uint64_t)(get_card_index(card) * (ZOBRIST_FACE_DOWN + 1) + location + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Returns the location that the card at a position in a pile rests on.
+ * base is the location of the bottom of the pile.
+ */
+static inline int get_zobrist_location(const Card *cards, int position, int base)
+{
+    return (position == 0) ? base : get_card_index(cards[position - 1]);
+}
+
+uint64_t compute_board_hash(const Board *board);
+
+#endif // ZOBRIST_H